@@ -38,22 +38,207 @@
 #define HTTP_H
 
 #include <stddef.h>
+#include <stdio.h>
+
+/**
+ * One response header, as spans into the response buffer (not NUL-terminated).
+ */
+typedef struct {
+    const char *name;     // Header name as received
+    size_t name_len;
+    const char *value;    // Header value without surrounding blanks
+    size_t value_len;
+    unsigned int hash;    // Case-insensitive hash of the name
+} HttpHeader;
+
+/**
+ * Well-known header names, whose hashes are computed once for faster lookups.
+ */
+typedef enum {
+    HTTP_HEADER_ACCEPT_RANGES,
+    HTTP_HEADER_AGE,
+    HTTP_HEADER_CACHE_CONTROL,
+    HTTP_HEADER_CONNECTION,
+    HTTP_HEADER_CONTENT_ENCODING,
+    HTTP_HEADER_CONTENT_LENGTH,
+    HTTP_HEADER_CONTENT_RANGE,
+    HTTP_HEADER_CONTENT_TYPE,
+    HTTP_HEADER_DATE,
+    HTTP_HEADER_ETAG,
+    HTTP_HEADER_EXPIRES,
+    HTTP_HEADER_LAST_MODIFIED,
+    HTTP_HEADER_LOCATION,
+    HTTP_HEADER_RETRY_AFTER,
+    HTTP_HEADER_SERVER,
+    HTTP_HEADER_SET_COOKIE,
+    HTTP_HEADER_TRANSFER_ENCODING,
+    HTTP_HEADER_VARY,
+    HTTP_HEADER_WELL_KNOWN_COUNT
+} HttpHeaderId;
 
 /**
  * Represents an HTTP response.
  */
 typedef struct {
     int status_code;      // HTTP status code (e.g., 200, 404)
-    char *headers;        // Response headers
-    char *body;           // Response body
+    char *headers;        // Response headers (view into buffer, NUL-terminated)
+    char *body;           // Response body (view into buffer, NUL-terminated)
+    size_t headers_len;   // Length of the headers
+    size_t body_len;      // Length of the body, which may contain NUL bytes
+    int complete;         // The whole message arrived (0 if the connection cut it short)
+    HttpHeader *header_fields;    // Parsed headers, in the order received (NULL if none)
+    size_t header_count;          // Number of parsed headers
+    unsigned int *header_index;   // Hash index over header_fields (internal)
+    size_t header_index_size;     // Number of slots in header_index (a power of two)
+    char *buffer;         // Receive buffer holding the bytes, this structure and the header table (internal)
 } HttpResponse;
 
 /**
- * Frees an HttpResponse structure.
+ * Socket transports used by the blocking request functions.
+ */
+typedef enum {
+    HTTP_TRANSPORT_CLASSIC,   // connect(), send() and recv()
+    HTTP_TRANSPORT_IO_URING   // io_uring with registered buffers
+} HttpTransport;
+
+/**
+ * TLS session resumption counters.
+ */
+typedef struct {
+    unsigned long hits;   // Handshakes that resumed a cached session
+    unsigned long misses; // Full handshakes
+} HttpTlsSessionStats;
+
+/**
+ * Receives body bytes as they arrive.
+ * @param data The bytes.
+ * @param len The number of bytes.
+ * @param userdata The pointer given in the request options.
+ * @return 0 to go on, non-zero to abort the transfer.
+ */
+typedef int (*HttpBodyCallback)(const char *data, size_t len, void *userdata);
+
+/**
+ * Sees the status and headers of a response before its body is passed on.
+ * @param response The response, with its headers and an empty body; only valid during the call.
+ * @param userdata The pointer given in the request options.
+ * @return 0 to go on, non-zero to abort the transfer before any body byte reaches the sink.
+ */
+typedef int (*HttpHeadersCallback)(const HttpResponse *response, void *userdata);
+
+/**
+ * Produces the next bytes of a request body sent in chunks.
+ * @param buffer Where to write the bytes.
+ * @param size The most bytes that can be written.
+ * @param userdata The producer_userdata pointer of the request options.
+ * @return The number of bytes written, 0 at the end of the body, or -1 to abort the request.
+ */
+typedef long (*HttpBodyProducer)(char *buffer, size_t size, void *userdata);
+
+/**
+ * Where the body of a response goes.
+ */
+typedef enum {
+    HTTP_SINK_MEMORY,     // Kept in HttpResponse.body (the default)
+    HTTP_SINK_CALLBACK,   // Handed to a callback
+    HTTP_SINK_FD,         // Written to a file descriptor
+    HTTP_SINK_FILE,       // Written to a stdio stream
+    HTTP_SINK_OUTPUT      // Written at an offset of an output file (see http_output.h)
+} HttpSinkType;
+
+/**
+ * Where the body of a request comes from.
+ */
+typedef enum {
+    HTTP_BODY_MEMORY,     // The body argument (the default)
+    HTTP_BODY_FD,         // A regular file, sent whole from its start with sendfile()
+    HTTP_BODY_PRODUCER    // A producer callback, sent with Transfer-Encoding: chunked
+} HttpBodySource;
+
+/**
+ * Content codings of a body (see http_decode.h and http_encode.h).
+ */
+typedef enum {
+    HTTP_CODING_IDENTITY,       // Not encoded
+    HTTP_CODING_GZIP,
+    HTTP_CODING_DEFLATE,
+    HTTP_CODING_ZSTD,
+    HTTP_CODING_UNSUPPORTED     // Unknown, not built in, or several codings stacked
+} HttpCoding;
+
+/**
+ * An output file bodies are written to at explicit offsets (see http_output.h).
+ */
+typedef struct HttpOutput HttpOutput;
+
+/**
+ * Options of http_request_ex(). Zero-initialize and set what is needed.
+ */
+typedef struct {
+    HttpSinkType sink;            // Where the body goes
+    HttpBodyCallback callback;    // HTTP_SINK_CALLBACK: receives the body
+    void *userdata;               // HTTP_SINK_CALLBACK/OUTPUT: passed to the callback and on_headers
+    HttpHeadersCallback on_headers;   // HTTP_SINK_CALLBACK/OUTPUT: checks the response before the first body byte (can be NULL)
+    int fd;                       // HTTP_SINK_FD: descriptor the body is written to
+    FILE *file;                   // HTTP_SINK_FILE: stream the body is written to
+    size_t window;                // Most body bytes held in memory when streaming (0 for 64 KB)
+    int zero_copy;                // HTTP_SINK_FD/FILE over plain http or kernel TLS: move the body with splice()
+    HttpOutput *output;           // HTTP_SINK_OUTPUT: file a 2xx body is written to, reserved from Content-Length
+    unsigned long long output_offset;   // HTTP_SINK_OUTPUT: where the first body byte goes (a 200 answering range goes at 0)
+    const char *range;            // Value of a Range header (e.g., "bytes=0-1023"), NULL for the whole body
+    const char *const *headers;   // Extra header lines ("Name: value", without CRLF), NULL-terminated (can be NULL)
+    size_t body_len;              // Length of a body holding NUL bytes (0 for strlen(body)); any size is sent uncopied
+    HttpBodySource body_source;   // Where the request body comes from
+    int body_fd;                  // HTTP_BODY_FD: file uploaded, its length taken from fstat()
+    HttpBodyProducer producer;    // HTTP_BODY_PRODUCER: makes the body as it is sent (not retried)
+    void *producer_userdata;      // HTTP_BODY_PRODUCER: passed to the producer
+    int keep_encoding;            // Non-zero to neither ask for compressed bodies nor decode them
+    size_t max_decoded;           // Most bytes a body kept in memory may decode to, or the request fails (0 for 256 MB)
+    HttpCoding body_coding;       // Compresses the request body while it is sent (chunked, with Content-Encoding)
+    int body_level;               // Compression level of body_coding (0 for the library default)
+} HttpRequestOptions;
+
+/**
+ * Frees an HttpResponse structure, its buffer and its header table, all held in one allocation.
  * @param response The HTTP response to free.
  */
 void http_response_free(HttpResponse *response);
 
+/**
+ * Looks up a response header by name, ignoring case.
+ * @param response The HTTP response.
+ * @param name The header name (e.g., "content-length").
+ * @return The first header with that name, or NULL if there is none.
+ */
+const HttpHeader* http_response_header(const HttpResponse *response, const char *name);
+
+/**
+ * Looks up a well-known response header without hashing its name.
+ * @param response The HTTP response.
+ * @param id The header.
+ * @return The first header with that name, or NULL if there is none.
+ */
+const HttpHeader* http_response_header_id(const HttpResponse *response, HttpHeaderId id);
+
+/**
+ * Finds the next header with the same name as a previous one (e.g., Set-Cookie).
+ * @param response The HTTP response.
+ * @param previous A header returned by a lookup.
+ * @return The next header with that name, or NULL if there is none.
+ */
+const HttpHeader* http_response_header_next(const HttpResponse *response, const HttpHeader *previous);
+
+/**
+ * Performs an HTTP request with options. When the body goes to a sink, the
+ * returned response holds the status and headers and an empty body.
+ * @param method The HTTP method.
+ * @param url The target URL.
+ * @param body The request body (can be NULL).
+ * @param options The options (can be NULL for the defaults).
+ * @return An HttpResponse or NULL on failure (including a sink that failed or aborted).
+ */
+HttpResponse* http_request_ex(const char *method, const char *url, const char *body, const HttpRequestOptions *options);
+
 /**
  * Performs an HTTP GET request.
  * @param url The target URL.
@@ -77,6 +262,22 @@ HttpResponse* http_post(const char *url, const char *body);
  */
 HttpResponse* http_put(const char *url, const char *body);
 
+/**
+ * Performs an HTTP POST request uploading a file, sent from the kernel with sendfile().
+ * @param url The target URL.
+ * @param fd A regular file, sent whole.
+ * @return An HttpResponse or NULL on failure.
+ */
+HttpResponse* http_post_fd(const char *url, int fd);
+
+/**
+ * Performs an HTTP PUT request uploading a file, sent from the kernel with sendfile().
+ * @param url The target URL.
+ * @param fd A regular file, sent whole.
+ * @return An HttpResponse or NULL on failure.
+ */
+HttpResponse* http_put_fd(const char *url, int fd);
+
 /**
  * Performs an HTTP DELETE request.
  * @param url The target URL.
@@ -137,4 +338,44 @@ HttpResponse* telnet_request(const char *url, const char *command);
  */
 HttpResponse* ssh_request(const char *url, const char *command);
 
+/**
+ * Sets how many idle keep-alive connections are kept per (scheme, host, port)
+ * and how long they may stay idle before being closed.
+ * @param max_idle_per_host Idle connections kept per origin (0 disables reuse).
+ * @param idle_timeout_seconds Seconds a connection may stay idle.
+ */
+void http_pool_set_limits(size_t max_idle_per_host, int idle_timeout_seconds);
+
+/**
+ * Backs the TLS session cache with a file shared between processes, so a new
+ * process can resume sessions negotiated by an earlier one. Sessions already
+ * in the file are loaded immediately; new ones are written as they arrive,
+ * the first one of each connection only.
+ * @param path The cache file (missing parent directories are created), or NULL to disable.
+ * @return 0 on success, -1 on failure.
+ */
+int http_tls_session_cache_file(const char *path);
+
+/**
+ * Reads the TLS session resumption counters.
+ * @param stats Receives the counters.
+ */
+void http_tls_session_stats(HttpTlsSessionStats *stats);
+
+/**
+ * Selects the socket transport. With io_uring, connecting, sending the
+ * request and reading the first bytes of a plain http response take a
+ * single system call. TLS connections use io_uring to connect only.
+ * @param transport The transport to use.
+ * @return 0 on success, -1 if io_uring is unavailable (the classic transport stays selected).
+ */
+int http_set_transport(HttpTransport transport);
+
+/**
+ * Releases the resources kept between requests (idle connections, the
+ * shared TLS context and cached TLS sessions). The session cache file, if
+ * any, is kept on disk.
+ */
+void http_cleanup(void);
+
 #endif // HTTP_H
@@ -0,0 +1,92 @@
+/**
+ * @file http_decode.h
+ * @brief Streaming response body decompression header in C.
+ *
+ * This file contains the declarations of the decoders that undo the
+ * Content-Encoding of a response body as it arrives.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Requests announce the codings the build supports in Accept-Encoding, and
+ * the response reader runs the body through a decoder between the parser
+ * and the body's destination. It includes functions to handle the following:
+ * - gzip (concatenated members included) and deflate, whether the server
+ *   sends it zlib-wrapped as the standard says or raw, with zlib when built
+ *   with HAVE_ZLIB.
+ * - zstd, with libzstd when built with HAVE_ZSTD.
+ * - Decoding into whatever output room the caller gives, so the same
+ *   window can be reused for every read.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_DECODE_H
+#define HTTP_DECODE_H
+
+#include "http.h"
+#include <stddef.h>
+
+typedef struct HttpDecoder HttpDecoder;
+
+/**
+ * Returns the Accept-Encoding value listing the codings this build decodes.
+ * @return The value (e.g., "gzip, deflate"), or NULL if it decodes none.
+ */
+const char* http_decode_accept(void);
+
+/**
+ * Works out the coding of a body from its Content-Encoding value.
+ * @param value The header value (not NUL-terminated).
+ * @param len The length of the value.
+ * @return The coding; HTTP_CODING_UNSUPPORTED if this build cannot decode it.
+ */
+HttpCoding http_decode_coding(const char *value, size_t len);
+
+/**
+ * Creates a decoder.
+ * @param coding A coding http_decode_coding() returned, other than identity and unsupported.
+ * @return The decoder, or NULL on failure.
+ */
+HttpDecoder* http_decoder_new(HttpCoding coding);
+
+/**
+ * Decodes encoded bytes into an output buffer. The decoder may hold output
+ * back when the room runs out: call again, with the rest of the input or
+ * none, until it leaves room unused.
+ * @param decoder The decoder.
+ * @param in The encoded bytes; advanced past those consumed.
+ * @param in_len Their number; decreased by those consumed.
+ * @param out Where the decoded bytes go.
+ * @param out_len The room in out; set to the number of bytes decoded.
+ * @return 0 on success, -1 on corrupt data.
+ */
+int http_decoder_run(HttpDecoder *decoder, const char **in, size_t *in_len, char *out, size_t *out_len);
+
+/**
+ * Tells whether the encoded stream ended properly, or never started.
+ * @param decoder The decoder.
+ * @return Non-zero if the body was decoded to its end.
+ */
+int http_decoder_done(const HttpDecoder *decoder);
+
+/**
+ * Frees a decoder.
+ * @param decoder The decoder (can be NULL).
+ */
+void http_decoder_free(HttpDecoder *decoder);
+
+#endif // HTTP_DECODE_H
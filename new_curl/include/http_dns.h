@@ -0,0 +1,132 @@
+/**
+ * @file http_dns.h
+ * @brief Host name resolution and DNS cache header in C.
+ *
+ * This file contains the declarations of the resolver the http requests
+ * functions go through to turn a host name into addresses to connect to.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Answers are cached in process, keyed by host name, for as long as their
+ * DNS time to live allows, and shared by every request and thread. It
+ * includes functions to handle the following:
+ * - Literal IPv4 addresses, taken as they are.
+ * - Names listed in /etc/hosts, then names asked to the DNS servers of
+ *   /etc/resolv.conf (or those set with http_dns_set_servers()), over UDP
+ *   and over TCP for answers too large for it, with the system resolver as
+ *   a last resort.
+ * - Other name services: lookups go through the system resolver when the
+ *   hosts line of /etc/nsswitch.conf lists sources besides files and dns
+ *   (mdns, myhostname, nis, ...), and no servers were set. Lookups that do
+ *   not block then block in it, so that every lookup resolves names alike.
+ * - Lookups that do not block: their socket is watched by the caller's
+ *   event loop, so lookups overlap each other and running transfers.
+ * - Threads asking for the same name at once: one resolves it, the others
+ *   wait for its answer.
+ * - Names that do not exist, remembered for as long as their zone says,
+ *   within a short bound, in a bounded number of entries.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_DNS_H
+#define HTTP_DNS_H
+
+#include <stddef.h>
+#include <netinet/in.h>
+
+#define HTTP_DNS_MAX_ADDRESSES 8
+
+/**
+ * Represents the addresses a host name resolved to.
+ */
+typedef struct {
+    struct in_addr addresses[HTTP_DNS_MAX_ADDRESSES];   // IPv4 addresses, in the order to try them
+    size_t count;                                       // Number of addresses
+} HttpDnsAddresses;
+
+typedef struct HttpDnsLookup HttpDnsLookup;
+
+/**
+ * Resolves a host name, from the cache when a live answer is there,
+ * waiting for the answer otherwise.
+ * @param host The host name or literal IPv4 address.
+ * @param result Where the addresses go.
+ * @return 0 on success, -1 if the name has no IPv4 address or could not be resolved.
+ */
+int http_dns_resolve(const char *host, HttpDnsAddresses *result);
+
+/**
+ * Starts resolving a host name without blocking. A literal address, a live
+ * cached answer or an /etc/hosts entry is answered right away; otherwise a
+ * query is sent and the lookup returned, to be driven by the caller: wait
+ * for its socket or its timeout, then call http_dns_lookup_process().
+ * @param host The host name or literal IPv4 address.
+ * @param result Where the addresses go when answered right away.
+ * @param lookup Set to the lookup under way, or to NULL when answered right away.
+ * @return 0 on success or with a lookup under way, -1 if the name has no IPv4 address or could not be resolved.
+ */
+int http_dns_lookup_start(const char *host, HttpDnsAddresses *result, HttpDnsLookup **lookup);
+
+/**
+ * Returns the socket a lookup waits on. It may change after each call to
+ * http_dns_lookup_process().
+ * @param lookup The lookup.
+ * @param want_write Set to non-zero if the socket is waited on for writing rather than reading (can be NULL).
+ * @return The socket.
+ */
+int http_dns_lookup_fd(const HttpDnsLookup *lookup, int *want_write);
+
+/**
+ * Tells how long a lookup may wait for its socket before it has to be
+ * processed anyway, to ask again or another server.
+ * @param lookup The lookup.
+ * @return The number of milliseconds, 0 if it is due.
+ */
+int http_dns_lookup_timeout(const HttpDnsLookup *lookup);
+
+/**
+ * Moves a lookup on, once its socket is ready or its time ran out. The
+ * answer goes into the cache like the ones of http_dns_resolve().
+ * @param lookup The lookup.
+ * @param result Where the addresses go once resolved.
+ * @return 1 once resolved, 0 if it still waits, -1 if the name has no IPv4 address or could not be resolved.
+ */
+int http_dns_lookup_process(HttpDnsLookup *lookup, HttpDnsAddresses *result);
+
+/**
+ * Frees a lookup, under way or not.
+ * @param lookup The lookup (can be NULL).
+ */
+void http_dns_lookup_free(HttpDnsLookup *lookup);
+
+/**
+ * Sets the DNS servers to ask instead of those of /etc/resolv.conf, whose
+ * other settings (search domains, timeout, attempts) still apply. Answers
+ * already cached are kept; http_dns_flush() drops them.
+ * @param servers IPv4 addresses with an optional port, separated by commas (e.g., "127.0.0.1:5353,10.0.0.1"),
+ *                or NULL to go back to /etc/resolv.conf.
+ * @return 0 on success, -1 if the list is malformed or names more than MAXNS servers.
+ */
+int http_dns_set_servers(const char *servers);
+
+/**
+ * Forgets every cached answer.
+ */
+void http_dns_flush(void);
+
+#endif // HTTP_DNS_H
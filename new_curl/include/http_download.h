@@ -0,0 +1,103 @@
+/**
+ * @file http_download.h
+ * @brief Parallel segmented download header in C.
+ *
+ * This file contains the declarations of the downloads that fetch one
+ * object as several byte ranges over parallel connections.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * A single TCP stream to a distant server rarely fills the link; several
+ * streams do. A segmented download includes the following:
+ * - A HEAD request learning the size of the object and whether the server
+ *   accepts byte ranges; otherwise the object is fetched in one piece.
+ * - Worker threads fetching consecutive ranges, each on its own
+ *   connection, and writing them at their offset in the output file.
+ * - Segments sized from the throughput each stream observed, and streams
+ *   added while they still raise the total throughput.
+ * - Failed or cut segments fetched again from where they stopped.
+ * - Resuming a download an earlier run left partial, from the size of the
+ *   file, as long as the object did not change meanwhile.
+ *
+ * @example
+ * #include "http_download.h"
+ *
+ * int main() {
+ *     HttpOutput *output = http_output_open("large.iso", HTTP_OUTPUT_MMAP);
+ *     int status = http_download("http://127.0.0.1/large.iso", output, NULL, NULL);
+ *     http_output_close(output);
+ *     return status == 0 ? 0 : 1;
+ * }
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_DOWNLOAD_H
+#define HTTP_DOWNLOAD_H
+
+#include "http.h"
+#include "http_output.h"
+#include <stddef.h>
+
+/**
+ * Options of http_download(). Zero-initialize and set what is needed.
+ */
+typedef struct {
+    size_t max_streams;   // Most parallel connections (0 for 8)
+    size_t min_segment;   // Smallest range requested (0 for 256 KB)
+    size_t max_segment;   // Largest range requested (0 for 64 MB)
+} HttpDownloadOptions;
+
+/**
+ * What a download did.
+ */
+typedef struct {
+    unsigned long long size;    // Size of the object
+    size_t segments;            // Range requests that completed
+    size_t retries;             // Range requests that failed and were sent again
+    size_t peak_streams;        // Most connections used at the same time
+    int segmented;              // Non-zero if the object was fetched in ranges
+    unsigned long long resumed_from;    // Bytes a resumed download found already in the file
+} HttpDownloadStats;
+
+/**
+ * Downloads an object into an output file, in parallel ranges when the
+ * server supports them.
+ * @param url The object URL.
+ * @param output The output file; the object is written from offset 0.
+ * @param options The options (can be NULL for the defaults).
+ * @param stats Receives what the download did (can be NULL).
+ * @return 0 on success, -1 on failure.
+ */
+int http_download(const char *url, HttpOutput *output, const HttpDownloadOptions *options, HttpDownloadStats *stats);
+
+/**
+ * Downloads an object into a file, resuming what an earlier, interrupted
+ * call left in it. The validator of the object (its strong ETag, or else
+ * its Last-Modified date) is kept in "<path>.resume" until the download
+ * completes; the rest of the object is asked for with an If-Range on it,
+ * so a changed object is fetched again from the start. Transfers cut
+ * short are resumed right away while they make progress. The object is
+ * asked for uncompressed, as its offsets are those of the identity body.
+ * @param url The object URL.
+ * @param path The output file.
+ * @param stats Receives what the download did (can be NULL).
+ * @return 0 on success, -1 on failure (the file and its validator are kept to resume later).
+ */
+int http_download_resume(const char *url, const char *path, HttpDownloadStats *stats);
+
+#endif // HTTP_DOWNLOAD_H
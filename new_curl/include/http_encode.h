@@ -0,0 +1,87 @@
+/**
+ * @file http_encode.h
+ * @brief Streaming request body compression header in C.
+ *
+ * This file contains the declarations of the encoders that compress a
+ * request body while it is sent.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * A request with a body_coding has its body, wherever it comes from, run
+ * through an encoder on its way to the connection and sent in chunks with
+ * a Content-Encoding header. It includes functions to handle the following:
+ * - gzip and deflate with zlib, when built with HAVE_ZLIB.
+ * - zstd with libzstd, when built with HAVE_ZSTD.
+ * - A compression level chosen per request, trading CPU time for bytes.
+ * - Compressing into whatever output room the caller gives, so the body is
+ *   never held compressed as a whole.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_ENCODE_H
+#define HTTP_ENCODE_H
+
+#include "http.h"
+#include <stddef.h>
+
+typedef struct HttpEncoder HttpEncoder;
+
+/**
+ * Returns the Content-Encoding name of a coding this build can compress with.
+ * @param coding The coding.
+ * @return The name (e.g., "gzip"), or NULL if the build cannot produce it.
+ */
+const char* http_encode_name(HttpCoding coding);
+
+/**
+ * Creates an encoder.
+ * @param coding HTTP_CODING_GZIP, HTTP_CODING_DEFLATE or HTTP_CODING_ZSTD.
+ * @param level The compression level (1-9 for gzip and deflate, 1-19 for
+ *              zstd), or 0 for the library default; out of range levels are clamped.
+ * @return The encoder, or NULL if the coding is not built in or on failure.
+ */
+HttpEncoder* http_encoder_new(HttpCoding coding, int level);
+
+/**
+ * Compresses bytes into an output buffer. The encoder may hold input back
+ * without output for a while, and output back when the room runs out:
+ * call again until it returns 1.
+ * @param encoder The encoder.
+ * @param in The body bytes; advanced past those consumed.
+ * @param in_len Their number; decreased by those consumed.
+ * @param finish Non-zero once in holds the last of the body.
+ * @param out Where the compressed bytes go.
+ * @param out_len The room in out; set to the number of bytes compressed.
+ * @return 1 once the last compressed byte is out, 0 if more calls are needed, -1 on failure.
+ */
+int http_encoder_run(HttpEncoder *encoder, const char **in, size_t *in_len, int finish, char *out, size_t *out_len);
+
+/**
+ * Makes an encoder start a new body, with the same coding and level.
+ * @param encoder The encoder.
+ * @return 0 on success, -1 on failure.
+ */
+int http_encoder_reset(HttpEncoder *encoder);
+
+/**
+ * Frees an encoder.
+ * @param encoder The encoder (can be NULL).
+ */
+void http_encoder_free(HttpEncoder *encoder);
+
+#endif // HTTP_ENCODE_H
@@ -0,0 +1,71 @@
+/**
+ * @file http_headers.h
+ * @brief Indexed response header table header in C.
+ *
+ * This file contains the declarations used to build the header table of an
+ * HttpResponse; the lookup functions themselves are declared in http.h.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * The table is an array of (name, value) spans in the order the headers
+ * were received, and an open-addressing hash index over it:
+ * - Names are hashed case-insensitively, so lookups need no strcasecmp
+ *   unless the hashes match.
+ * - The array and the index are laid out in memory the caller provides,
+ *   after the response itself in its receive buffer.
+ * - The hashes of the well-known names are computed once per process.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_HEADERS_H
+#define HTTP_HEADERS_H
+
+#include "http.h"
+#include <stddef.h>
+
+/**
+ * Hashes a header name, ignoring ASCII case.
+ * @param name The name.
+ * @param len The length of the name.
+ * @return The hash.
+ */
+unsigned int http_header_hash(const char *name, size_t len);
+
+/**
+ * Returns the number of bytes the header table of a response takes.
+ * @param count The number of headers.
+ * @return The size of the array and its index.
+ */
+size_t http_headers_size(size_t count);
+
+/**
+ * Lays out the header table of a response in the given memory.
+ * @param response The response.
+ * @param memory At least http_headers_size(count) bytes, suitably aligned.
+ * @param count The number of headers.
+ * @return The array to fill with the name and value spans.
+ */
+HttpHeader* http_headers_place(HttpResponse *response, void *memory, size_t count);
+
+/**
+ * Hashes the names of the headers filled in and builds the index.
+ * @param response The response, after http_headers_place() and filling the spans.
+ */
+void http_headers_index(HttpResponse *response);
+
+#endif // HTTP_HEADERS_H
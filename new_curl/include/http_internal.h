@@ -0,0 +1,118 @@
+/**
+ * @file http_internal.h
+ * @brief Internal http requests helpers header in C.
+ *
+ * This file contains the declarations of the helpers that http.c shares
+ * with the other modules of the library. They are not part of the public API.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * url_parser.h defines its functions in the header, so only http.c may
+ * include it. Other modules go through these helpers to:
+ * - Split a URL into the origin and path of a request.
+ * - Format the request head and body.
+ * - Turn a received response into an HttpResponse.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_INTERNAL_H
+#define HTTP_INTERNAL_H
+
+#include "http.h"
+#include "http_reader.h"
+#include <stddef.h>
+
+/**
+ * The origin and path a request is sent to.
+ */
+typedef struct {
+    const char *scheme;   // "http" or "https"
+    char *host;           // Origin host
+    int port;             // Origin port (defaulted from the scheme)
+    char *path;           // Request target ("/" if the URL has none)
+    int use_ssl;          // Non-zero for https
+} HttpTarget;
+
+/**
+ * Parses a URL into a request target.
+ * @param url The target URL.
+ * @param use_ssl Non-zero to talk TLS to the origin.
+ * @param target Receives the target; release it with http_target_free().
+ * @return 0 on success, -1 on an invalid URL.
+ */
+int http_target_parse(const char *url, int use_ssl, HttpTarget *target);
+
+/**
+ * Frees the strings held by a request target.
+ * @param target The target to release.
+ */
+void http_target_free(HttpTarget *target);
+
+/**
+ * Tells whether a request asks for compressed bodies (and decodes them):
+ * it does when the build decodes some coding, unless it is a HEAD request,
+ * which has no body to decode and whose Content-Length must count the
+ * bytes a range counts, or the options ask for a range, keep_encoding or
+ * their own Accept-Encoding header.
+ * @param method The HTTP method.
+ * @param options The request options (can be NULL).
+ * @return Non-zero if Accept-Encoding is sent.
+ */
+int http_accepts_encoding(const char *method, const HttpRequestOptions *options);
+
+/**
+ * Tells whether sockets go through io_uring: it is used only if selected
+ * with http_set_transport() and available on the calling thread.
+ * @return Non-zero if io_uring is used.
+ */
+int http_use_uring(void);
+
+/**
+ * Formats the request line and header block of a request, up to the empty
+ * line before the body, which is sent separately.
+ * @param head The output buffer.
+ * @param size The size of the output buffer.
+ * @param target The request target.
+ * @param method The HTTP method.
+ * @param body_len The length of the body (ignored for a chunked producer body).
+ * @param options The request options adding headers (can be NULL).
+ * @return The length of the header block, or 0 if an extra header line holds a CR or LF.
+ *         If it is size or more, the block did not fit: format it again into a larger buffer.
+ */
+size_t http_format_head(char *head, size_t size, const HttpTarget *target, const char *method, size_t body_len,
+                        const HttpRequestOptions *options);
+
+/**
+ * Returns how many bytes a buffer must hold for a response to be laid out
+ * after its first len bytes: the structure and its header table.
+ * @param len The number of bytes of the message.
+ * @param header_count The number of headers.
+ * @return The size of the buffer.
+ */
+size_t http_response_size(size_t len, size_t header_count);
+
+/**
+ * Builds an HttpResponse from the response a reader collected and parsed.
+ * The response takes over the receive buffer: its headers and body are
+ * views into it, and nothing is copied.
+ * @param reader The reader, after the header block was received.
+ * @return An HttpResponse or NULL on failure.
+ */
+HttpResponse* parse_http_response(HttpReader *reader);
+
+#endif // HTTP_INTERNAL_H
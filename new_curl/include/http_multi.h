@@ -0,0 +1,131 @@
+/**
+ * @file http_multi.h
+ * @brief Concurrent http requests header in C.
+ *
+ * This file contains the declarations of the multi interface, which runs
+ * many http requests concurrently on one thread.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Requests are added to a multi handle and driven by an epoll loop on
+ * non-blocking sockets. Resolving the host, connecting, the TLS handshake,
+ * sending and receiving are resumable states, so a transfer waiting on the
+ * network never blocks the others. It includes functions to handle the following:
+ * - Creating and destroying a multi handle.
+ * - Queueing requests, with a cap on how many run at the same time.
+ * - Advancing every ready transfer without blocking, or waiting for activity.
+ * - Plugging into an outer event loop, with a descriptor and a timeout.
+ *
+ * @example
+ * #include "http_multi.h"
+ *
+ * static void done(HttpResponse *response, void *userdata) {
+ *     printf("%s: %d\n", (const char *)userdata, response ? response->status_code : -1);
+ *     http_response_free(response);
+ * }
+ *
+ * int main() {
+ *     HttpMulti *multi = http_multi_create(64);
+ *     http_multi_add(multi, "GET", "http://127.0.0.1/a", NULL, done, "a");
+ *     http_multi_add(multi, "GET", "http://127.0.0.1/b", NULL, done, "b");
+ *     while (http_multi_poll(multi, 1000) > 0);
+ *     http_multi_destroy(multi);
+ *     return 0;
+ * }
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_MULTI_H
+#define HTTP_MULTI_H
+
+#include "http.h"
+#include <stddef.h>
+
+/**
+ * A set of concurrently running http requests.
+ */
+typedef struct HttpMulti HttpMulti;
+
+/**
+ * Called once per request when it finishes.
+ * @param response The response, owned by the callee (NULL on failure).
+ * @param userdata The pointer given to http_multi_add().
+ */
+typedef void (*HttpMultiCallback)(HttpResponse *response, void *userdata);
+
+/**
+ * Creates a multi handle.
+ * @param max_active How many requests may run at the same time (0 for the default of 64).
+ * @return A multi handle or NULL on failure.
+ */
+HttpMulti* http_multi_create(size_t max_active);
+
+/**
+ * Queues a request. It starts on the next call to http_multi_perform() or
+ * http_multi_poll() if fewer than max_active requests are running.
+ * @param multi The multi handle.
+ * @param method The HTTP method.
+ * @param url The target URL.
+ * @param body The request body (can be NULL); it is copied.
+ * @param done Called when the request finishes.
+ * @param userdata Passed to done.
+ * @return 0 on success, -1 on failure (done is not called).
+ */
+int http_multi_add(HttpMulti *multi, const char *method, const char *url, const char *body,
+                   HttpMultiCallback done, void *userdata);
+
+/**
+ * Advances every transfer that can make progress without blocking.
+ * @param multi The multi handle.
+ * @return The number of requests not finished yet, or -1 on failure.
+ */
+int http_multi_perform(HttpMulti *multi);
+
+/**
+ * Waits up to timeout_ms for network activity, then advances the transfers.
+ * @param multi The multi handle.
+ * @param timeout_ms The longest time to wait (-1 waits indefinitely).
+ * @return The number of requests not finished yet, or -1 on failure.
+ */
+int http_multi_poll(HttpMulti *multi, int timeout_ms);
+
+/**
+ * Returns the epoll descriptor of the multi handle, which becomes readable
+ * when http_multi_perform() has work to do. It lets an outer event loop
+ * wait on the multi handle along with its own descriptors.
+ * @param multi The multi handle.
+ * @return The descriptor.
+ */
+int http_multi_fd(const HttpMulti *multi);
+
+/**
+ * Tells how long an outer event loop may wait on http_multi_fd() before
+ * calling http_multi_perform() anyway, for host lookups whose answer is
+ * late to ask again or another server.
+ * @param multi The multi handle.
+ * @return The number of milliseconds, or -1 if nothing has a deadline.
+ */
+int http_multi_timeout(const HttpMulti *multi);
+
+/**
+ * Aborts the unfinished requests (their callbacks get NULL) and frees the multi handle.
+ * @param multi The multi handle.
+ */
+void http_multi_destroy(HttpMulti *multi);
+
+#endif // HTTP_MULTI_H
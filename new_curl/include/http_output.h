@@ -0,0 +1,117 @@
+/**
+ * @file http_output.h
+ * @brief Download output file header in C.
+ *
+ * This file contains the declarations of the output files response bodies
+ * can be written to.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * An output file is written at explicit offsets, so several transfers can
+ * fill disjoint parts of it at the same time. It includes functions to
+ * handle the following:
+ * - Reserving the whole file up front with fallocate() once its size is
+ *   known, which avoids fragmentation and repeated size updates.
+ * - Optionally mapping the reserved file, so that bodies are copied
+ *   straight into the page cache instead of going through write(). A file
+ *   on a filesystem without fallocate() is written with pwrite() instead.
+ * - Trimming the file to what was actually written when it is closed.
+ *
+ * @example
+ * #include "http_output.h"
+ *
+ * int main() {
+ *     HttpOutput *output = http_output_open("page.html", HTTP_OUTPUT_MMAP);
+ *     HttpRequestOptions options = {0};
+ *     options.sink = HTTP_SINK_OUTPUT;
+ *     options.output = output;
+ *     http_response_free(http_request_ex("GET", "http://127.0.0.1/", NULL, &options));
+ *     return http_output_close(output) == 0 ? 0 : 1;
+ * }
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_OUTPUT_H
+#define HTTP_OUTPUT_H
+
+#include "http.h"
+#include <stddef.h>
+
+/**
+ * Flags of http_output_open().
+ */
+#define HTTP_OUTPUT_MMAP 0x1    // Write through a shared mapping once the size is reserved
+#define HTTP_OUTPUT_KEEP 0x2    // Keep what the file holds, to resume it (never mapped; see below)
+
+/**
+ * Opens (creating or truncating) an output file. With HTTP_OUTPUT_KEEP the
+ * file is not truncated, and reserving does not grow it: the file then
+ * always ends at the last byte written in order, even after a crash, so
+ * its size tells how much of a download it holds.
+ * @param path The file path.
+ * @param flags HTTP_OUTPUT_* flags.
+ * @return The output, or NULL on failure (errno is set).
+ */
+HttpOutput* http_output_open(const char *path, int flags);
+
+/**
+ * Reserves the file up to size bytes, and maps it if asked to. Reserving
+ * again with a size not larger than the current one does nothing.
+ * @param output The output.
+ * @param size The final size of the file.
+ * @return 0 on success, -1 on failure (no space left, for instance).
+ */
+int http_output_reserve(HttpOutput *output, unsigned long long size);
+
+/**
+ * Writes bytes at an offset. Safe to call from several threads for disjoint ranges.
+ * @param output The output.
+ * @param offset Where the bytes go in the file.
+ * @param data The bytes.
+ * @param len The number of bytes.
+ * @return 0 on success, -1 on failure.
+ */
+int http_output_write_at(HttpOutput *output, unsigned long long offset, const char *data, size_t len);
+
+/**
+ * Returns the end of the furthest write, or the size of the file kept by HTTP_OUTPUT_KEEP.
+ */
+unsigned long long http_output_size(const HttpOutput *output);
+
+/**
+ * Cuts the file to size bytes, dropping its mapping and reservation, to
+ * write it again from there.
+ * @param output The output, with no write in progress.
+ * @param size The new size.
+ * @return 0 on success, -1 on failure.
+ */
+int http_output_truncate(HttpOutput *output, unsigned long long size);
+
+/**
+ * Returns the file descriptor of the output.
+ */
+int http_output_fd(const HttpOutput *output);
+
+/**
+ * Unmaps and closes the file, trimming it to the end of the furthest write.
+ * @param output The output (freed).
+ * @return 0 on success, -1 on failure.
+ */
+int http_output_close(HttpOutput *output);
+
+#endif // HTTP_OUTPUT_H
@@ -0,0 +1,156 @@
+/**
+ * @file http_parser.h
+ * @brief Incremental HTTP/1.1 response parser header in C.
+ *
+ * This file contains the declarations of a push-based, resumable parser for
+ * HTTP/1.1 responses.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * The parser is fed byte slices as they arrive, of any size and split
+ * anywhere, and never looks at a byte twice. It reports what it finds
+ * through callbacks:
+ * - The status line, then every header, then the end of the header block.
+ * - Body bytes, as pointers into the slice being parsed; chunked bodies
+ *   come without their framing, one run of chunk data at a time.
+ * - The trailer fields after the last chunk.
+ * - The end of the message, which it finds from Content-Length, chunked
+ *   framing or the connection closing.
+ *
+ * Status reason and header positions are given as offsets from the first
+ * byte fed to the parser, because a header may span two slices. Callers
+ * that keep the header block contiguous (as the response reader does) turn
+ * them into pointers; the parser itself never buffers.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <stddef.h>
+
+typedef struct HttpParser HttpParser;
+
+/**
+ * Parser events. Each callback returns 0 to go on; any other value stops
+ * the parser with HTTP_PARSER_ERROR_CALLBACK. Unused callbacks can be NULL.
+ */
+typedef struct {
+    int (*on_status)(HttpParser *parser, size_t reason_offset, size_t reason_len);
+    int (*on_header)(HttpParser *parser, size_t name_offset, size_t name_len,
+                     size_t value_offset, size_t value_len);
+    int (*on_headers_complete)(HttpParser *parser);
+    int (*on_body)(HttpParser *parser, const char *data, size_t len);
+    int (*on_trailer)(HttpParser *parser, size_t name_offset, size_t name_len,
+                      size_t value_offset, size_t value_len);
+    int (*on_message_complete)(HttpParser *parser);
+} HttpParserCallbacks;
+
+/**
+ * Parser errors.
+ */
+typedef enum {
+    HTTP_PARSER_OK = 0,
+    HTTP_PARSER_ERROR_STATUS_LINE,      // Malformed status line
+    HTTP_PARSER_ERROR_HEADER,           // Malformed header line
+    HTTP_PARSER_ERROR_CONTENT_LENGTH,   // Invalid or conflicting Content-Length
+    HTTP_PARSER_ERROR_CHUNK,            // Malformed chunk framing
+    HTTP_PARSER_ERROR_TRUNCATED,        // Connection closed before the end of the message
+    HTTP_PARSER_ERROR_CALLBACK          // A callback asked to stop
+} HttpParserError;
+
+/**
+ * Parser state. Fields are read-only for callers.
+ */
+struct HttpParser {
+    const HttpParserCallbacks *callbacks;
+    void *userdata;                 // Free for the caller's use
+    int state;
+    HttpParserError error;
+    size_t offset;                  // Offset of the next byte to parse (inside callbacks: right after the current byte)
+    size_t message_offset;          // Offset of the status line of the response being parsed
+    int http_major;
+    int http_minor;
+    int status_code;
+    long long content_length;       // -1 if the server sent none
+    unsigned long long remaining;   // Bytes left in the body or the current chunk
+    int chunked;                    // Body uses chunked transfer encoding
+    int trailers;                   // Parsing the trailer section after the last chunk
+    size_t trailer_offset;          // Offset where the trailer section started
+    int connection_close;           // Server sent Connection: close
+    int connection_keep_alive;      // Server sent Connection: keep-alive
+    int head_request;               // Response to a HEAD request (no body)
+    int message_complete;
+    size_t mark;                    // Offset where the current token started
+    size_t name_offset;
+    size_t name_len;
+    size_t value_end;               // Offset right after the last non-blank value byte
+    unsigned int name_match;        // Known header names still matching the current name
+    unsigned int token_match;       // Known tokens still matching the current value token
+    size_t token_len;
+    int token_params;               // Skipping the parameters of the current value token
+    int header_kind;                // Known header being parsed (0 if none)
+    int digits;                     // Digits seen in the current number
+};
+
+/**
+ * Prepares a parser for one response.
+ * @param parser The parser.
+ * @param callbacks The event callbacks (kept by reference).
+ * @param userdata Stored in parser->userdata.
+ * @param head_request Non-zero if the response answers a HEAD request.
+ */
+void http_parser_init(HttpParser *parser, const HttpParserCallbacks *callbacks, void *userdata, int head_request);
+
+/**
+ * Parses the next slice of the response.
+ * @param parser The parser.
+ * @param data The bytes.
+ * @param len The number of bytes.
+ * @return The number of bytes consumed. It is less than len if the message
+ *         ended inside the slice or on error (check parser->error).
+ */
+size_t http_parser_execute(HttpParser *parser, const char *data, size_t len);
+
+/**
+ * Accounts for body bytes the caller moved elsewhere without parsing them,
+ * for example with splice(). Only bodies without chunked framing can be
+ * skipped; on_body is not called for the skipped bytes.
+ * @param parser The parser.
+ * @param len The number of body bytes.
+ * @return The number of bytes accounted for, at most what is left of the body
+ *         (0 if the parser is not inside such a body).
+ */
+size_t http_parser_skip(HttpParser *parser, size_t len);
+
+/**
+ * Tells the parser the connection was closed. This ends a body that runs
+ * until the connection closes.
+ * @param parser The parser.
+ * @return 0 if the message is complete, -1 if it was truncated.
+ */
+int http_parser_finish(HttpParser *parser);
+
+/**
+ * Tells whether the connection can carry another request after this response.
+ * @param parser The parser, after the headers were parsed.
+ * @return Non-zero if the connection can be kept alive.
+ */
+int http_parser_keep_alive(const HttpParser *parser);
+
+#endif // HTTP_PARSER_H
@@ -0,0 +1,89 @@
+/**
+ * @file http_pool.h
+ * @brief Keep-alive connection pool header in C.
+ *
+ * This file contains the declarations of the connection pool used by the
+ * http requests functions to reuse sockets and TLS sessions between calls.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Idle connections are keyed by (scheme, host, port). The pool handles:
+ * - Handing out an idle connection that is still alive.
+ * - Taking a connection back once its response has been fully read.
+ * - Evicting connections that stayed idle too long or exceed the per-host limit.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+#include <time.h>
+#include <openssl/ssl.h>
+
+/**
+ * Represents an open connection to an origin.
+ */
+typedef struct HttpConnection {
+    int sockfd;                     // Connected socket
+    SSL *ssl;                       // TLS session (NULL for plain http)
+    char *scheme;                   // Origin scheme ("http" or "https")
+    char *host;                     // Origin host
+    int port;                       // Origin port
+    int reused;                     // Non-zero if taken from the pool
+    time_t last_used;               // When the connection went idle
+    struct HttpConnection *next;    // Next idle connection in the pool
+} HttpConnection;
+
+/**
+ * Wraps a freshly connected socket into a connection.
+ * @param sockfd The connected socket.
+ * @param ssl The TLS session on top of the socket (can be NULL).
+ * @param scheme The origin scheme.
+ * @param host The origin host.
+ * @param port The origin port.
+ * @return A connection or NULL on failure (the socket is left open).
+ */
+HttpConnection* http_connection_new(int sockfd, SSL *ssl, const char *scheme, const char *host, int port);
+
+/**
+ * Shuts down and frees a connection.
+ * @param conn The connection to close.
+ */
+void http_connection_close(HttpConnection *conn);
+
+/**
+ * Takes an idle, still open connection to the given origin out of the pool.
+ * @param scheme The origin scheme.
+ * @param host The origin host.
+ * @param port The origin port.
+ * @return A connection or NULL if none is available.
+ */
+HttpConnection* http_pool_acquire(const char *scheme, const char *host, int port);
+
+/**
+ * Puts a connection back into the pool once its response is complete.
+ * @param conn The connection to keep alive.
+ */
+void http_pool_release(HttpConnection *conn);
+
+/**
+ * Closes every idle connection held by the pool.
+ */
+void http_pool_clear(void);
+
+#endif // HTTP_POOL_H
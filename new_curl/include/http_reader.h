@@ -0,0 +1,205 @@
+/**
+ * @file http_reader.h
+ * @brief HTTP response reader header in C.
+ *
+ * This file contains the declarations of the response reader, which
+ * collects a complete HTTP/1.1 response from the bytes read off a connection.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * The reader owns a growable receive buffer and feeds every byte read to
+ * the incremental response parser, which finds where the message ends.
+ * It handles the following:
+ * - Content-Length bodies: once the headers are in, the buffer is resized
+ *   to the exact size of the message, so the body needs no more reallocs.
+ * - Chunked bodies, decoded in place as they arrive: the framing is
+ *   dropped and the trailer fields are listed with the headers.
+ * - Bodies delimited by the server closing the connection.
+ * - Responses without a body (HEAD, 1xx, 204, 304); interim 1xx responses are skipped.
+ * - Streaming: body bytes go to a sink as they arrive and their room in the
+ *   buffer is reused, so memory stays within the header block plus a window.
+ * - Compressed bodies, decoded as they arrive into a buffer of their own,
+ *   up to a maximum size, or into one window reused for every read when
+ *   streaming.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_READER_H
+#define HTTP_READER_H
+
+#include <stddef.h>
+#include "http.h"
+#include "http_decode.h"
+#include "http_parser.h"
+
+/**
+ * Position of one header of the final response in the receive buffer.
+ */
+typedef struct {
+    size_t name_offset;
+    size_t name_len;
+    size_t value_offset;
+    size_t value_len;
+} HttpReaderField;
+
+/**
+ * Called once the headers of the final response are in, before any body byte.
+ * @param userdata The sink's userdata.
+ * @return 0 to go on, non-zero to fail the transfer.
+ */
+typedef int (*HttpReaderHeadersCallback)(void *userdata);
+
+/**
+ * Accumulates one HTTP response.
+ */
+typedef struct {
+    char *data;                 // Received bytes, always NUL-terminated
+    size_t len;                 // Number of bytes received
+    size_t cap;                 // Allocated bytes, not counting the terminating NUL
+    size_t reserve;             // Room kept after the message for the response built from it
+    size_t headers_start;       // Offset of the status line of the final response
+    size_t headers_len;         // Length of its header block with the blank line (0 until received)
+    size_t body_len;            // Number of body bytes in the buffer
+    size_t trailers_len;        // Trailer bytes packed after the body and its NUL
+    size_t dropped;             // Bytes streamed out of the buffer (parser offsets minus buffer offsets)
+    unsigned long long body_received;   // Number of body bytes received, kept or streamed
+    HttpReaderField *fields;    // Headers, then trailers, reported by the parser
+    size_t field_count;
+    size_t field_cap;
+    long long content_length;   // Body length announced by the server (-1 if none)
+    int status_code;            // Status of the final response (0 until known)
+    int chunked;                // Body uses chunked transfer encoding
+    int keep_alive;             // Connection may be reused after this response
+    int complete;               // The whole message has been received
+    HttpBodyCallback sink;      // Receives the body instead of the buffer (NULL to keep it)
+    void *sink_userdata;
+    HttpReaderHeadersCallback sink_headers;     // Settles the sink once the headers are in (can be NULL)
+    size_t window;              // Most body bytes read at once when streaming
+    int sink_failed;            // The sink failed or aborted the transfer
+    int decode;                 // Decode bodies with a Content-Encoding this build supports
+    HttpDecoder *decoder;       // Decodes the body of this response (NULL if it is not encoded)
+    char *decoded;              // Decoded body, or the window it is decoded into when streaming
+    size_t decoded_len;         // Number of decoded body bytes kept
+    size_t decoded_cap;
+    size_t max_decoded;         // Most decoded body bytes kept, past which the response fails
+    int too_large;              // The decoded body went past max_decoded
+    HttpParser parser;          // Parses the bytes as they are committed
+} HttpReader;
+
+/**
+ * Prepares a reader for the response to a request.
+ * @param reader The reader.
+ * @param method The HTTP method of the request.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int http_reader_init(HttpReader *reader, const char *method);
+
+/**
+ * Sends the body to a sink instead of keeping it in the buffer.
+ * @param reader The reader, right after http_reader_init().
+ * @param sink Receives the body bytes as they arrive.
+ * @param userdata Passed to the sink.
+ * @param window Most body bytes read at once (0 for 64 KB).
+ */
+void http_reader_stream(HttpReader *reader, HttpBodyCallback sink, void *userdata, size_t window);
+
+/**
+ * Lets a streaming sink look at the response as soon as its headers are
+ * in, whether or not a body follows.
+ * @param reader The reader, after http_reader_stream().
+ * @param callback Called with the sink's userdata; failing it fails the transfer like a failing sink.
+ */
+void http_reader_on_headers(HttpReader *reader, HttpReaderHeadersCallback callback);
+
+/**
+ * Decodes the body of the response when its Content-Encoding is one
+ * http_decode_accept() lists. The body then ends up in the decoded buffer
+ * (or goes decoded to the sink) instead of the receive buffer. A body kept
+ * in memory that decodes to more than max_decoded bytes fails the response,
+ * so that a small compressed body cannot fill the memory.
+ * @param reader The reader, right after http_reader_init().
+ * @param max_decoded Most decoded bytes kept when not streaming (0 for 256 MB).
+ */
+void http_reader_decode(HttpReader *reader, size_t max_decoded);
+
+/**
+ * Returns where the next read should store its bytes, growing the buffer if needed.
+ * @param reader The reader.
+ * @param avail Receives how many bytes may be read; never more than what is left of the message when its length is known,
+ *              nor more than the window when streaming.
+ * @return The destination, or NULL on allocation failure.
+ */
+char* http_reader_buffer(HttpReader *reader, size_t *avail);
+
+/**
+ * Accounts for bytes just read into the buffer from http_reader_buffer().
+ * @param reader The reader.
+ * @param n The number of bytes read.
+ * @return 1 once the response is complete, 0 if more bytes are needed, -1 on a malformed response.
+ */
+int http_reader_commit(HttpReader *reader, size_t n);
+
+/**
+ * Returns how much of the body can still be moved to the sink's destination
+ * without going through the reader, as splice() does. That is possible once
+ * the headers are in, when streaming a body that has no chunked framing and
+ * is not being decoded.
+ * @param reader The reader.
+ * @return The number of body bytes left, SIZE_MAX if the body runs until the
+ *         connection closes, or 0 if the rest cannot be moved that way.
+ */
+size_t http_reader_raw_left(const HttpReader *reader);
+
+/**
+ * Accounts for body bytes moved to the sink's destination by the caller.
+ * @param reader The reader.
+ * @param n The number of bytes moved.
+ * @return 1 once the response is complete, 0 if more bytes are needed, -1 on error.
+ */
+int http_reader_skip(HttpReader *reader, size_t n);
+
+/**
+ * Tells the reader the server closed the connection.
+ * @param reader The reader.
+ * @return 1 if that ends the response, 0 if the response is truncated.
+ */
+int http_reader_close(HttpReader *reader);
+
+/**
+ * Hands the receive buffer over to the caller, grown to at least size bytes.
+ * @param reader The reader; it no longer owns the buffer afterwards.
+ * @param size The number of bytes the caller needs.
+ * @return The buffer, to release with free(), or NULL on allocation failure.
+ */
+char* http_reader_take(HttpReader *reader, size_t size);
+
+/**
+ * Hands the decoded body buffer over to the caller, grown to at least size bytes.
+ * @param reader The reader, holding a decoded body it did not stream; it no longer owns the buffer afterwards.
+ * @param size The number of bytes the caller needs.
+ * @return The buffer, to release with free(), or NULL on allocation failure.
+ */
+char* http_reader_take_decoded(HttpReader *reader, size_t size);
+
+/**
+ * Frees the receive buffer, the header positions and the decoder.
+ * @param reader The reader.
+ */
+void http_reader_free(HttpReader *reader);
+
+#endif // HTTP_READER_H
@@ -0,0 +1,78 @@
+/**
+ * @file http_scan.h
+ * @brief Vectorized header scanning header in C.
+ *
+ * This file contains the declarations of the scanner the response parser
+ * uses to skip over header names, header values and reason phrases in bulk.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * The scanner looks for the first byte that ends a header line or that may
+ * not appear in one: CR, LF and the other control bytes (HT excepted), and
+ * for header names the colon too, in the same pass. It checks 16 bytes per
+ * step with SSE2, or one at a time on other CPUs; the AVX2 variant, 32
+ * bytes per step, is slower on typical headers and only used when forced,
+ * as benchmarks can force any variant the CPU supports.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_SCAN_H
+#define HTTP_SCAN_H
+
+#include <stddef.h>
+
+/**
+ * Scanner variants.
+ */
+typedef enum {
+    HTTP_SCAN_SCALAR,   // One byte at a time, any CPU
+    HTTP_SCAN_SSE2,     // 16 bytes per step, x86-64
+    HTTP_SCAN_AVX2      // 32 bytes per step, x86-64 with AVX2
+} HttpScanImpl;
+
+/**
+ * Finds the first byte of [p, end) that is a control byte other than HT
+ * (so CR and LF included) or DEL.
+ * @param p Where to start.
+ * @param end The end of the bytes.
+ * @return The byte found, or end if there is none.
+ */
+const char* http_scan_line(const char *p, const char *end);
+
+/**
+ * Finds the first byte of [p, end) that is a colon, or a byte
+ * http_scan_line() stops at: the end of a header name, or where it breaks.
+ * @param p Where to start.
+ * @param end The end of the bytes.
+ * @return The byte found, or end if there is none.
+ */
+const char* http_scan_name(const char *p, const char *end);
+
+/**
+ * Selects the scanner variant, for benchmarks and tests.
+ * @param impl The variant.
+ * @return 0 on success, -1 if the CPU does not support it.
+ */
+int http_scan_use(HttpScanImpl impl);
+
+/**
+ * Returns the variant used by default: SSE2 on x86-64, scalar elsewhere.
+ */
+HttpScanImpl http_scan_best(void);
+
+#endif // HTTP_SCAN_H
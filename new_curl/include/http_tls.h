@@ -0,0 +1,91 @@
+/**
+ * @file http_tls.h
+ * @brief TLS context management header in C.
+ *
+ * This file contains the declarations of the process-wide TLS context used
+ * by the https requests functions.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * OpenSSL is initialized once and a single SSL_CTX is shared by every
+ * request and thread. It includes functions to handle the following:
+ * - Lazily creating the shared context on the first https request.
+ * - Performing client handshakes that resume cached sessions per host:port.
+ * - Offloading record encryption to kernel TLS where available.
+ * - Tearing the context and the session cache down on cleanup.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_TLS_H
+#define HTTP_TLS_H
+
+#include <openssl/ssl.h>
+
+/**
+ * Returns the shared TLS client context, creating it on first use.
+ * @return The shared context or NULL on failure.
+ */
+SSL_CTX* http_tls_context(void);
+
+/**
+ * Creates a TLS client session on a connected socket, offering the session
+ * cached for host:port. The caller drives SSL_connect() itself, which lets
+ * non-blocking sockets resume the handshake, then calls
+ * http_tls_handshake_done().
+ * @param sockfd The connected socket.
+ * @param host The origin host.
+ * @param port The origin port.
+ * @return The TLS session, ready for SSL_connect(), or NULL on failure.
+ */
+SSL* http_tls_new(int sockfd, const char *host, int port);
+
+/**
+ * Counts a completed handshake as a session resumption hit or miss.
+ * @param ssl The TLS session whose handshake just completed.
+ */
+void http_tls_handshake_done(SSL *ssl);
+
+/**
+ * Performs a TLS client handshake on a connected socket, offering the
+ * session cached for host:port and counting whether it was resumed.
+ * @param sockfd The connected socket.
+ * @param host The origin host.
+ * @param port The origin port.
+ * @return The established TLS session or NULL on failure.
+ */
+SSL* http_tls_connect(int sockfd, const char *host, int port);
+
+/**
+ * Directions of a TLS session handled by kernel TLS.
+ */
+#define HTTP_KTLS_SEND 0x1    // Records are encrypted by the kernel (sendfile() works)
+#define HTTP_KTLS_RECV 0x2    // Records are decrypted by the kernel (splice() works)
+
+/**
+ * Tells which directions of an established TLS session the kernel took over.
+ * @param ssl The TLS session, after its handshake.
+ * @return A mask of HTTP_KTLS_* flags, 0 if user space handles both.
+ */
+int http_tls_ktls(SSL *ssl);
+
+/**
+ * Frees the shared TLS context and the cached sessions. The next https request creates a new one.
+ */
+void http_tls_cleanup(void);
+
+#endif // HTTP_TLS_H
@@ -0,0 +1,109 @@
+/**
+ * @file http_uring.h
+ * @brief io_uring socket transport header in C.
+ *
+ * This file contains the declarations of the io_uring transport that the
+ * http requests functions can use instead of connect()/send()/recv().
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Each thread owns a small ring with two registered buffers, one for
+ * outgoing and one for incoming bytes. The transport handles:
+ * - Probing whether the kernel supports the operations it needs.
+ * - Submitting connect, send and receive as one linked batch, so that the
+ *   first exchange of a request costs a single io_uring_enter() call.
+ * - Plain sends and receives on an already connected socket.
+ * - Sends and receives on many connected sockets in one batch.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HTTP_URING_H
+#define HTTP_URING_H
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/**
+ * One send or receive of a batch.
+ */
+typedef struct {
+    int sockfd;           // Connected socket
+    int send;             // Non-zero to send buf, zero to receive into it
+    void *buf;            // Bytes to send, or where received bytes go
+    size_t len;           // Bytes to send, or room in buf
+    int result;           // Bytes sent or received (0 if the peer closed), or -errno (-EAGAIN if the socket was not ready)
+} HttpUringOp;
+
+/**
+ * Tells whether io_uring can be used on the calling thread, setting up the
+ * thread's ring on first use.
+ * @return Non-zero if the io_uring transport is available.
+ */
+int http_uring_available(void);
+
+/**
+ * Connects a socket through the ring.
+ * @param sockfd The socket.
+ * @param addr The peer address.
+ * @param addrlen The size of addr.
+ * @return 0 on success, -1 on failure (errno is set).
+ */
+int http_uring_connect(int sockfd, const struct sockaddr *addr, socklen_t addrlen);
+
+/**
+ * Optionally connects, then sends a request and receives the first bytes of
+ * the response, all in one linked submission.
+ * @param sockfd The socket.
+ * @param addr The peer address, or NULL if the socket is already connected.
+ * @param addrlen The size of addr.
+ * @param request The bytes to send, in order (e.g., the header block, then the body).
+ * @param request_count The number of entries of request.
+ * @param response Receives the first bytes of the response.
+ * @param response_cap The size of response.
+ * @param connect_failed Set to non-zero if connecting failed, nothing being sent then, and to 0 otherwise (can be NULL).
+ * @return The number of bytes received (0 if the peer closed), or -1 on failure (errno is set).
+ */
+ssize_t http_uring_exchange(int sockfd, const struct sockaddr *addr, socklen_t addrlen,
+                            const struct iovec *request, int request_count,
+                            void *response, size_t response_cap, int *connect_failed);
+
+/**
+ * Sends on and receives from many connected sockets with one io_uring_enter()
+ * call per ring-full of operations. No operation waits for its socket to be
+ * ready: each one does what send() or recv() with MSG_DONTWAIT would.
+ * @param ops The operations; their result is set.
+ * @param count The number of operations.
+ * @return 0 once every operation has its result, -1 if they could not be submitted (errno is set).
+ */
+int http_uring_batch(HttpUringOp *ops, size_t count);
+
+/**
+ * Sends bytes on a connected socket through the ring.
+ * @return The number of bytes sent, or -1 on failure (errno is set).
+ */
+ssize_t http_uring_send(int sockfd, const void *buf, size_t len);
+
+/**
+ * Receives bytes from a connected socket through the ring.
+ * @return The number of bytes received (0 if the peer closed), or -1 on failure (errno is set).
+ */
+ssize_t http_uring_recv(int sockfd, void *buf, size_t len);
+
+#endif // HTTP_URING_H
@@ -34,193 +34,1098 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
+#define _GNU_SOURCE
 #include "http.h"
+#include "http_decode.h"
+#include "http_dns.h"
+#include "http_encode.h"
+#include "http_headers.h"
+#include "http_internal.h"
+#include "http_output.h"
+#include "http_pool.h"
+#include "http_reader.h"
+#include "http_tls.h"
+#include "http_uring.h"
 #include "url_parser.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
+static HttpTransport transport = HTTP_TRANSPORT_CLASSIC;
+
+int http_use_uring(void) {
+    return transport == HTTP_TRANSPORT_IO_URING && http_uring_available();
+}
+
+/* Connects to the addresses of a host in turn, until one accepts */
 static int connect_to_host(const char *host, int port) {
-    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    if (sockfd < 0) {
-        perror("Socket creation failed");
+    HttpDnsAddresses addresses;
+    if (http_dns_resolve(host, &addresses) < 0) {
+        fprintf(stderr, "Could not resolve host: %s\n", host);
         return -1;
     }
 
-    struct sockaddr_in server_addr = {
-        .sin_family = AF_INET,
-        .sin_port = htons(port)
-    };
+    for (size_t i = 0; i < addresses.count; i++) {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        if (sockfd < 0) {
+            perror("Socket creation failed");
+            return -1;
+        }
 
-    if (inet_pton(AF_INET, host, &server_addr.sin_addr) <= 0) {
-        perror("Invalid host address");
+        struct sockaddr_in server_addr = {
+            .sin_family = AF_INET,
+            .sin_port = htons(port),
+            .sin_addr = addresses.addresses[i]
+        };
+        int ret;
+        if (http_use_uring()) {
+            ret = http_uring_connect(sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        } else {
+            ret = connect(sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        }
+        if (ret == 0) return sockfd;
         close(sockfd);
-        return -1;
     }
+    perror("Connection failed");
+    return -1;
+}
 
-    if (connect(sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
-        perror("Connection failed");
-        close(sockfd);
-        return -1;
-    }
+#define RESPONSE_ALIGN 16
 
-    return sockfd;
+/* The response structure starts at the first aligned offset after the message and its NUL */
+static size_t response_offset(size_t len) {
+    return (len + 1 + RESPONSE_ALIGN - 1) & ~(size_t)(RESPONSE_ALIGN - 1);
 }
 
-static HttpResponse* parse_http_response(const char *response) {
-    if (!response) return NULL;
+size_t http_response_size(size_t len, size_t header_count) {
+    return response_offset(len) + sizeof(HttpResponse) + (header_count ? http_headers_size(header_count) : 0);
+}
 
-    HttpResponse *http_response = malloc(sizeof(HttpResponse));
-    if (!http_response) return NULL;
+/* Lays out an empty response after the first len bytes of a buffer of http_response_size() bytes */
+static HttpResponse* place_response(char *buffer, size_t len) {
+    HttpResponse *response = (HttpResponse*)(buffer + response_offset(len));
+    memset(response, 0, sizeof(HttpResponse));
+    response->buffer = buffer;
+    return response;
+}
 
-    http_response->status_code = 0;
-    http_response->headers = NULL;
-    http_response->body = NULL;
+/* Turns len raw bytes held in a malloc'ed buffer into a response whose body they are */
+static HttpResponse* raw_response(char *buffer, size_t len) {
+    char *block = realloc(buffer, http_response_size(len, 0));
+    if (!block) {
+        free(buffer);
+        return NULL;
+    }
+
+    HttpResponse *response = place_response(block, len);
+    block[len] = '\0';
+    response->body = block;
+    response->body_len = len;
+    return response;
+}
 
-    const char *status_line = strstr(response, "HTTP/");
-    if (status_line) {
-        sscanf(status_line, "HTTP/%*d.%*d %d", &http_response->status_code);
+/* Points a response at the header block and header fields of a reader, moved by shift bytes into its buffer */
+static void place_headers(HttpResponse *response, const HttpReader *reader, char *buffer, ptrdiff_t shift) {
+    char *headers = buffer + (reader->headers_start + shift);
+    size_t headers_len = reader->headers_len;
+    while (headers_len && (headers[headers_len - 1] == '\r' || headers[headers_len - 1] == '\n')) headers_len--;
+    response->headers = headers;
+    response->headers_len = headers_len;
+    response->headers[headers_len] = '\0';
+
+    if (reader->field_count) {
+        HttpHeader *fields = http_headers_place(response, response + 1, reader->field_count);
+        for (size_t i = 0; i < reader->field_count; i++) {
+            const HttpReaderField *field = &reader->fields[i];
+            fields[i].name = buffer + (field->name_offset + shift);
+            fields[i].name_len = field->name_len;
+            fields[i].value = buffer + (field->value_offset + shift);
+            fields[i].value_len = field->value_len;
+        }
+        http_headers_index(response);
     }
+}
+
+/* Copies the status and headers a reader holds so far into a response without a body */
+static HttpResponse* header_response(const HttpReader *reader) {
+    size_t len = reader->headers_len;
+    char *buffer = malloc(http_response_size(len, reader->field_count));
+    if (!buffer) return NULL;
+    memcpy(buffer, reader->data + reader->headers_start, len);
 
-    const char *headers_end = strstr(response, "\r\n\r\n");
-    if (headers_end) {
-        size_t headers_len = headers_end - response;
-        http_response->headers = strndup(response, headers_len);
-        http_response->body = strdup(headers_end + 4);
+    HttpResponse *response = place_response(buffer, len);
+    response->status_code = reader->status_code;
+    place_headers(response, reader, buffer, -(ptrdiff_t)reader->headers_start);
+    response->body = buffer + len;
+    buffer[len] = '\0';
+    return response;
+}
+
+HttpResponse* parse_http_response(HttpReader *reader) {
+    if (!reader || !reader->headers_len) return NULL;
+
+    size_t body_offset = reader->headers_start + reader->headers_len;
+    size_t end = body_offset + reader->body_len;
+    /* Trailer fields of a chunked body are packed after the body's NUL */
+    size_t kept = reader->trailers_len ? end + 1 + reader->trailers_len : end;
+    char *buffer;
+    ptrdiff_t shift = 0;    // Where the header block moved in the response buffer
+    size_t body_len = reader->body_len;
+    if (reader->decoder && !reader->sink) {
+        /* A decoded body is in a buffer of its own, too large to copy: the
+           header block (and trailers) is copied after it and its NUL instead */
+        body_len = reader->decoded_len;
+        size_t block_len = kept - reader->headers_start;
+        buffer = http_reader_take_decoded(reader, http_response_size(body_len + 1 + block_len, reader->field_count));
+        if (!buffer) return NULL;
+        memcpy(buffer + body_len + 1, reader->data + reader->headers_start, block_len);
+        shift = (ptrdiff_t)(body_len + 1) - (ptrdiff_t)reader->headers_start;
+        end = body_len;
+        kept = body_len + 1 + block_len;
+        body_offset = 0;
+    } else {
+        buffer = http_reader_take(reader, http_response_size(kept, reader->field_count));
+        if (!buffer) return NULL;
     }
 
+    HttpResponse *http_response = place_response(buffer, kept);
+    http_response->status_code = reader->status_code;
+    http_response->complete = reader->complete;
+
+    /* The parser already located everything: the header block runs from the
+       status line to the blank line, and the body follows it. Both are
+       NUL-terminated in place, over the blank line and after the body. */
+    place_headers(http_response, reader, buffer, shift);
+    http_response->body = buffer + body_offset;
+    http_response->body_len = body_len;
+    buffer[end] = '\0';
     return http_response;
 }
 
-static HttpResponse* http_request(const char *url, const char *method, const char *body, int use_ssl) {
+/* Connects to the origin and performs the TLS handshake when needed */
+static HttpConnection* open_connection(const char *scheme, const char *host, int port, int use_ssl) {
+    int sockfd = connect_to_host(host, port);
+    if (sockfd < 0) return NULL;
+
+    SSL *ssl = NULL;
+    if (use_ssl) {
+        ssl = http_tls_connect(sockfd, host, port);
+        if (!ssl) {
+            close(sockfd);
+            return NULL;
+        }
+    }
+
+    HttpConnection *conn = http_connection_new(sockfd, ssl, scheme, host, port);
+    if (!conn) {
+        perror("Memory allocation failed");
+        SSL_free(ssl);
+        close(sockfd);
+    }
+    return conn;
+}
+
+int http_target_parse(const char *url, int use_ssl, HttpTarget *target) {
+    memset(target, 0, sizeof(HttpTarget));
+
     char *cleaned_url = clean_url(url);
-    if (!cleaned_url) return NULL;
+    if (!cleaned_url) return -1;
 
     Url *parsed_url = url_parse(cleaned_url);
     free(cleaned_url);
     if (!parsed_url || !parsed_url->host || !parsed_url->scheme) {
         fprintf(stderr, "Invalid URL\n");
         url_free(parsed_url);
+        return -1;
+    }
+
+    target->scheme = use_ssl ? "https" : "http";
+    target->port = parsed_url->port > 0 ? parsed_url->port : (use_ssl ? 443 : 80);
+    target->use_ssl = use_ssl;
+    target->host = parsed_url->host;
+    target->path = parsed_url->path ? parsed_url->path : strdup("/");
+    parsed_url->host = NULL;
+    parsed_url->path = NULL;
+    url_free(parsed_url);
+
+    if (!target->host || !target->path) {
+        http_target_free(target);
+        return -1;
+    }
+    return 0;
+}
+
+void http_target_free(HttpTarget *target) {
+    free(target->host);
+    free(target->path);
+    target->host = NULL;
+    target->path = NULL;
+}
+
+/* Appends to a request, keeping count of the bytes it would take untruncated */
+static size_t append_request(char *request, size_t size, size_t len, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(len < size ? request + len : NULL, len < size ? size - len : 0, format, args);
+    va_end(args);
+    return n < 0 ? len : len + (size_t)n;
+}
+
+int http_accepts_encoding(const char *method, const HttpRequestOptions *options) {
+    if (!http_decode_accept() || strcmp(method, "HEAD") == 0) return 0;
+    if (!options) return 1;
+    /* A range counts in encoded bytes, and a caller asking for codings itself decodes them */
+    if (options->keep_encoding || options->range) return 0;
+    for (const char *const *header = options->headers; header && *header; header++) {
+        if (strncasecmp(*header, "Accept-Encoding:", 16) == 0) return 0;
+    }
+    return 1;
+}
+
+size_t http_format_head(char *head, size_t size, const HttpTarget *target, const char *method, size_t body_len,
+                        const HttpRequestOptions *options) {
+    size_t len = append_request(head, size, 0,
+             "%s %s HTTP/1.1\r\n"
+             "Host: %s\r\n"
+             "Connection: keep-alive\r\n",
+             method,
+             target->path,
+             target->host);
+    if (options && options->range) len = append_request(head, size, len, "Range: %s\r\n", options->range);
+    if (http_accepts_encoding(method, options)) len = append_request(head, size, len, "Accept-Encoding: %s\r\n", http_decode_accept());
+    for (const char *const *header = options ? options->headers : NULL; header && *header; header++) {
+        /* A line break would let the header smuggle in others */
+        if (strpbrk(*header, "\r\n")) return 0;
+        len = append_request(head, size, len, "%s\r\n", *header);
+    }
+    if (options && options->body_coding != HTTP_CODING_IDENTITY) {
+        const char *coding = http_encode_name(options->body_coding);
+        if (!coding) return 0;
+        len = append_request(head, size, len, "Content-Encoding: %s\r\n", coding);
+    }
+    if (options && (options->body_source == HTTP_BODY_PRODUCER || options->body_coding != HTTP_CODING_IDENTITY)) {
+        return append_request(head, size, len, "Transfer-Encoding: chunked\r\n\r\n");
+    }
+    return append_request(head, size, len, "Content-Length: %zu\r\n\r\n", body_len);
+}
+
+/* The addresses a connection not made yet tries in turn, until one accepts */
+typedef struct {
+    HttpDnsAddresses addresses;
+    int port;
+} PendingConnect;
+
+/*
+ * With io_uring on plain http, a new connection is only a socket: connect()
+ * is submitted together with the request and the first read.
+ */
+static HttpConnection* open_pending_connection(const HttpTarget *target, PendingConnect *pending) {
+    if (http_dns_resolve(target->host, &pending->addresses) < 0) {
+        fprintf(stderr, "Could not resolve host: %s\n", target->host);
         return NULL;
     }
+    pending->port = target->port;
 
-    int port = parsed_url->port > 0 ? parsed_url->port : (use_ssl ? 443 : 80);
-    int sockfd = connect_to_host(parsed_url->host, port);
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
     if (sockfd < 0) {
-        url_free(parsed_url);
+        perror("Socket creation failed");
         return NULL;
     }
 
-    SSL_CTX *ctx = NULL;
-    SSL *ssl = NULL;
-    if (use_ssl) {
-        SSL_library_init();
-        SSL_load_error_strings();
-        OpenSSL_add_ssl_algorithms();
-        ctx = SSL_CTX_new(TLS_client_method());
-        if (!ctx) {
-            fprintf(stderr, "Unable to create SSL context\n");
-            ERR_print_errors_fp(stderr);
-            close(sockfd);
-            url_free(parsed_url);
-            return NULL;
+    HttpConnection *conn = http_connection_new(sockfd, NULL, target->scheme, target->host, target->port);
+    if (!conn) {
+        perror("Memory allocation failed");
+        close(sockfd);
+    }
+    return conn;
+}
+
+static int transport_recv(HttpConnection *conn, char *buf, int len) {
+    if (conn->ssl) return SSL_read(conn->ssl, buf, len);
+    if (http_use_uring()) return (int)http_uring_recv(conn->sockfd, buf, len);
+    return (int)recv(conn->sockfd, buf, len, 0);
+}
+
+/* Largest single read, so that a huge Content-Length still fits SSL_read()'s int */
+#define MAX_READ (1 << 30)
+
+/* Largest TLS record payload: the header block and the first body bytes are sent as one */
+#define TLS_RECORD_SIZE 16384
+
+/*
+ * Writes the request from where its parts lie: the header block, then the
+ * body straight from the caller's memory. On plain sockets one sendmsg()
+ * takes all of it, so the header block and the start of the body share a
+ * packet; over TLS they share the first record. With more set, the
+ * kernel holds a partial packet back for the bytes sent next.
+ */
+static int send_request(HttpConnection *conn, const struct iovec *request, int request_count, int more) {
+    if (conn->ssl) {
+        char first[TLS_RECORD_SIZE];
+        size_t first_len = 0;
+        int i = 0;
+        size_t done = 0;
+        /* Parts that fit entirely, then the start of the next one */
+        for (; i < request_count && first_len < sizeof(first); i++) {
+            size_t take = request[i].iov_len < sizeof(first) - first_len ? request[i].iov_len : sizeof(first) - first_len;
+            memcpy(first + first_len, request[i].iov_base, take);
+            first_len += take;
+            if (take < request[i].iov_len) {
+                done = take;
+                break;
+            }
         }
-        ssl = SSL_new(ctx);
-        SSL_set_fd(ssl, sockfd);
-        if (SSL_connect(ssl) <= 0) {
-            fprintf(stderr, "SSL connection failed\n");
-            ERR_print_errors_fp(stderr);
-            SSL_free(ssl);
-            SSL_CTX_free(ctx);
-            close(sockfd);
-            url_free(parsed_url);
-            return NULL;
+        size_t written;
+        if (first_len > 0 && SSL_write_ex(conn->ssl, first, first_len, &written) <= 0) return -1;
+        for (; i < request_count; i++, done = 0) {
+            if (request[i].iov_len > done &&
+                SSL_write_ex(conn->ssl, (const char *)request[i].iov_base + done, request[i].iov_len - done, &written) <= 0) {
+                return -1;
+            }
         }
+        return 0;
     }
 
-    char request[4096];
-    snprintf(request, sizeof(request),
-             "%s %s HTTP/1.1\r\n"
-             "Host: %s\r\n"
-             "Connection: close\r\n"
-             "Content-Length: %zu\r\n\r\n%s",
-             method,
-             parsed_url->path ? parsed_url->path : "/",
-             parsed_url->host,
-             body ? strlen(body) : 0,
-             body ? body : "");
+    struct iovec iov[2];
+    if (request_count > 2) return -1;
+    memcpy(iov, request, request_count * sizeof(struct iovec));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = request_count;
+    while (msg.msg_iovlen > 0) {
+        ssize_t n = sendmsg(conn->sockfd, &msg, MSG_NOSIGNAL | (more ? MSG_MORE : 0));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return -1;
+        /* Skip what went out, then go on from the first part not fully sent */
+        while (msg.msg_iovlen > 0 && (size_t)n >= msg.msg_iov->iov_len) {
+            n -= (ssize_t)msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov->iov_base = (char *)msg.msg_iov->iov_base + n;
+            msg.msg_iov->iov_len -= (size_t)n;
+        }
+    }
+    return 0;
+}
 
-    if (use_ssl) {
-        SSL_write(ssl, request, strlen(request));
+/* What a request sends: the header block, then a body from memory, a file or a producer */
+typedef struct {
+    struct iovec parts[2];      // Header block, then the body if it is in memory
+    int count;
+    int body_fd;                // Regular file the body is read from instead (-1 if none)
+    unsigned long long body_len;
+    HttpBodyProducer producer;  // Produces a chunked body instead (NULL if none)
+    void *producer_userdata;
+    int produced;               // The producer was called: the body cannot be sent again
+} OutgoingRequest;
+
+/* Body bytes asked from the producer per chunk */
+#define PRODUCER_CHUNK 65536
+/* Room before a chunk for its size line: up to 16 hex digits and CRLF */
+#define CHUNK_PREFIX 18
+
+/*
+ * Sends a body made by a producer, as chunks of whatever it returns. The
+ * producer writes in place after room left for the size line, and the
+ * first chunk goes out together with the header block.
+ */
+static int send_chunked_request(HttpConnection *conn, OutgoingRequest *request) {
+    char *buffer = malloc(CHUNK_PREFIX + PRODUCER_CHUNK + 2);
+    if (!buffer) return -1;
+
+    char *data = buffer + CHUNK_PREFIX;
+    struct iovec parts[2] = { request->parts[0], { NULL, 0 } };
+    int count = 2;
+    int status = 0;
+    for (;;) {
+        request->produced = 1;
+        long n = request->producer(data, PRODUCER_CHUNK, request->producer_userdata);
+        if (n < 0 || n > PRODUCER_CHUNK) {
+            status = -1;
+            break;
+        }
+
+        /* The last chunk has size 0 and no data, only the empty trailer */
+        char size_line[CHUNK_PREFIX + 1];
+        int prefix = snprintf(size_line, sizeof(size_line), "%lx\r\n", n);
+        memcpy(data - prefix, size_line, (size_t)prefix);
+        memcpy(data + n, "\r\n", 2);
+        parts[count - 1].iov_base = data - prefix;
+        parts[count - 1].iov_len = (size_t)prefix + (size_t)n + 2;
+        if (send_request(conn, parts, count, 0) < 0) {
+            status = -1;
+            break;
+        }
+        if (n == 0) break;
+        parts[0] = parts[1];
+        count = 1;
+    }
+
+    free(buffer);
+    return status;
+}
+
+/* Bytes handed to one sendfile() call, which moves less than 2 GB at once anyway */
+#define SENDFILE_CHUNK (1 << 30)
+
+/*
+ * Sends a file body after its header block. On plain sockets the header
+ * block is sent with MSG_MORE so that it leaves in the same packet as the
+ * start of the file, which sendfile() then moves without it ever reaching
+ * user space. So does SSL_sendfile() once kernel TLS encrypts the records.
+ * Otherwise TLS needs the bytes to encrypt them: they are read in record
+ * sized pieces, the first one sharing its record with the header block.
+ */
+static int send_file_request(HttpConnection *conn, const OutgoingRequest *request) {
+    off_t offset = 0;
+    if (!conn->ssl) {
+        if (send_request(conn, request->parts, 1, 1) < 0) return -1;
+        while ((unsigned long long)offset < request->body_len) {
+            unsigned long long left = request->body_len - (unsigned long long)offset;
+            ssize_t n = sendfile(conn->sockfd, request->body_fd, &offset, left < SENDFILE_CHUNK ? (size_t)left : SENDFILE_CHUNK);
+            if (n < 0 && errno == EINTR) continue;
+            /* 0: the file shrank since its length was announced */
+            if (n <= 0) return -1;
+        }
+        return 0;
+    }
+
+    if (http_tls_ktls(conn->ssl) & HTTP_KTLS_SEND) {
+        size_t written;
+        if (SSL_write_ex(conn->ssl, request->parts[0].iov_base, request->parts[0].iov_len, &written) <= 0) return -1;
+        while ((unsigned long long)offset < request->body_len) {
+            unsigned long long left = request->body_len - (unsigned long long)offset;
+            ossl_ssize_t n = SSL_sendfile(conn->ssl, request->body_fd, offset, left < SENDFILE_CHUNK ? (size_t)left : SENDFILE_CHUNK, 0);
+            if (n <= 0) return -1;
+            offset += n;
+        }
+        return 0;
+    }
+
+    char record[TLS_RECORD_SIZE];
+    size_t head_len = request->parts[0].iov_len;
+    size_t fill = head_len < sizeof(record) ? head_len : 0;
+    size_t written;
+    if (fill) {
+        memcpy(record, request->parts[0].iov_base, head_len);
+    } else if (SSL_write_ex(conn->ssl, request->parts[0].iov_base, head_len, &written) <= 0) {
+        return -1;
+    }
+    while ((unsigned long long)offset < request->body_len) {
+        unsigned long long left = request->body_len - (unsigned long long)offset;
+        size_t want = sizeof(record) - fill < left ? sizeof(record) - fill : (size_t)left;
+        ssize_t n = pread(request->body_fd, record + fill, want, offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        offset += n;
+        if (SSL_write_ex(conn->ssl, record, fill + (size_t)n, &written) <= 0) return -1;
+        fill = 0;
+    }
+    if (fill && SSL_write_ex(conn->ssl, record, fill, &written) <= 0) return -1;
+    return 0;
+}
+
+/*
+ * Submits connect, the request and the first read to each address of a
+ * pending connection in turn, on a fresh socket after each refused connect,
+ * as connect_to_host() does. Returns the number of bytes read, or -1.
+ */
+static int exchange_connecting(HttpConnection *conn, const PendingConnect *pending,
+                               const OutgoingRequest *request, char *buf, size_t avail) {
+    for (size_t i = 0; i < pending->addresses.count; i++) {
+        if (i > 0) {
+            int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+            if (sockfd < 0) {
+                perror("Socket creation failed");
+                return -1;
+            }
+            close(conn->sockfd);
+            conn->sockfd = sockfd;
+        }
+
+        struct sockaddr_in server_addr = {
+            .sin_family = AF_INET,
+            .sin_port = htons(pending->port),
+            .sin_addr = pending->addresses.addresses[i]
+        };
+        int connect_failed;
+        ssize_t n = http_uring_exchange(conn->sockfd, (const struct sockaddr *)&server_addr, sizeof(server_addr),
+                                        request->parts, request->count, buf, avail, &connect_failed);
+        /* Once connected, the request may have gone out: it is not sent anywhere else */
+        if (!connect_failed) return (int)n;
+    }
+    perror("Connection failed");
+    return -1;
+}
+
+/*
+ * Sends the request and reads the first bytes of the response, connecting
+ * first if pending is given. Returns the number of bytes read, or -1.
+ */
+static int exchange(HttpConnection *conn, const PendingConnect *pending,
+                    OutgoingRequest *request, HttpReader *reader) {
+    size_t avail;
+    char *buf = http_reader_buffer(reader, &avail);
+    if (!buf) return -1;
+    if (avail > MAX_READ) avail = MAX_READ;
+
+    if (!conn->ssl && http_use_uring() && request->body_fd < 0 && !request->producer) {
+        if (pending) return exchange_connecting(conn, pending, request, buf, avail);
+        return (int)http_uring_exchange(conn->sockfd, NULL, 0, request->parts, request->count, buf, avail, NULL);
+    }
+
+    int sent = request->body_fd >= 0 ? send_file_request(conn, request)
+             : request->producer ? send_chunked_request(conn, request)
+             : send_request(conn, request->parts, request->count, 0);
+    if (sent < 0) return -1;
+    return transport_recv(conn, buf, (int)avail);
+}
+
+/* Bytes moved per splice() call; the pipe is grown to match when allowed */
+#define SPLICE_CHUNK (1 << 20)
+
+/* Writes out what is left in the pipe with read()/write() */
+static int drain_pipe(int pipe_fd, int out_fd, size_t len) {
+    char buf[16384];
+    while (len > 0) {
+        ssize_t n = read(pipe_fd, buf, len < sizeof(buf) ? len : sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        for (ssize_t done = 0; done < n;) {
+            ssize_t m = write(out_fd, buf + done, n - done);
+            if (m < 0 && errno == EINTR) continue;
+            if (m < 0) return -1;
+            done += m;
+        }
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* splice_body() result when the caller must go on reading instead */
+#define SPLICE_UNAVAILABLE 2
+
+/*
+ * Moves the rest of a body from the socket to out_fd through a pipe, so the
+ * bytes never reach user space (over kernel TLS, they arrive decrypted). Returns 1 once the response is
+ * complete, 0 if the connection ended it early, -1 on failure, and
+ * SPLICE_UNAVAILABLE if nothing was moved because splice() cannot be used.
+ */
+static int splice_body(HttpConnection *conn, HttpReader *reader, int out_fd) {
+    /* splice() refuses files opened for appending */
+    int flags = fcntl(out_fd, F_GETFL);
+    if (flags < 0 || (flags & O_APPEND)) return SPLICE_UNAVAILABLE;
+
+    int pipefd[2];
+    if (pipe2(pipefd, O_CLOEXEC) < 0) return SPLICE_UNAVAILABLE;
+    fcntl(pipefd[1], F_SETPIPE_SZ, SPLICE_CHUNK);
+
+    int status;
+    int moved_any = 0;
+    for (;;) {
+        size_t left = http_reader_raw_left(reader);
+        if (left == 0) {
+            status = reader->complete ? 1 : -1;
+            break;
+        }
+
+        ssize_t in = splice(conn->sockfd, NULL, pipefd[1], NULL, left < SPLICE_CHUNK ? left : SPLICE_CHUNK,
+                            SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (in < 0 && errno == EINTR) continue;
+        if (in < 0) {
+            status = moved_any || (errno != EINVAL && errno != ENOSYS) ? -1 : SPLICE_UNAVAILABLE;
+            break;
+        }
+        if (in == 0) {
+            status = http_reader_close(reader);
+            break;
+        }
+
+        for (ssize_t pending = in; pending > 0;) {
+            ssize_t out = splice(pipefd[0], NULL, out_fd, NULL, pending, SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (out < 0 && errno == EINTR) continue;
+            if (out <= 0) {
+                /* out_fd does not take splice() (a terminal, for instance): copy what is in the pipe */
+                if (drain_pipe(pipefd[0], out_fd, pending) < 0) in = -1;
+                break;
+            }
+            pending -= out;
+        }
+        if (in < 0 || http_reader_skip(reader, in) < 0) {
+            status = -1;
+            break;
+        }
+        moved_any = 1;
+        if (reader->complete) {
+            status = 1;
+            break;
+        }
+    }
+
+    close(pipefd[0]);
+    close(pipefd[1]);
+    return status;
+}
+
+/* A TLS body can be spliced once the kernel decrypts the records and OpenSSL holds none of it */
+static int tls_spliceable(SSL *ssl) {
+    return (http_tls_ktls(ssl) & HTTP_KTLS_RECV) && !SSL_has_pending(ssl);
+}
+
+/*
+ * Reads the rest of the response. Returns 1 once it is complete, 0 if the
+ * connection ended it early and -1 on a malformed response. With splice_fd
+ * set, a body the kernel sees in plaintext (plain http, or kernel TLS) is
+ * moved to it with splice() once the headers are in.
+ */
+static int read_response(HttpConnection *conn, HttpReader *reader, int n, int splice_fd) {
+    while (n > 0) {
+        int status = http_reader_commit(reader, n);
+        if (status != 0) return status;
+
+        if (splice_fd >= 0 && (!conn->ssl || tls_spliceable(conn->ssl)) && http_reader_raw_left(reader)) {
+            status = splice_body(conn, reader, splice_fd);
+            if (status != SPLICE_UNAVAILABLE) return status;
+            splice_fd = -1;
+        }
+
+        size_t avail;
+        char *buf = http_reader_buffer(reader, &avail);
+        if (!buf) return -1;
+        n = transport_recv(conn, buf, avail > MAX_READ ? MAX_READ : (int)avail);
+    }
+    return http_reader_close(reader);
+}
+
+static int sink_fd(const char *data, size_t len, void *userdata) {
+    int fd = *(const int*)userdata;
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int sink_file(const char *data, size_t len, void *userdata) {
+    return fwrite(data, 1, len, (FILE*)userdata) == len ? 0 : -1;
+}
+
+/* State of an HTTP_SINK_OUTPUT transfer */
+typedef struct {
+    const HttpRequestOptions *options;    // For on_headers
+    HttpOutput *output;
+    unsigned long long offset;    // Where the next body byte goes
+    const HttpReader *reader;     // For the status and announced length
+    int ranged;                   // A range was asked for
+    int discard;                  // Not a 2xx body: the file is left alone
+} OutputSink;
+
+/* Settles where the body goes once the headers are in, body or not, and
+   reserves the whole file once so it lands in preallocated (and possibly
+   mapped) space */
+static int settle_output(void *userdata) {
+    OutputSink *sink = userdata;
+    if (sink->options->on_headers) {
+        HttpResponse *response = header_response(sink->reader);
+        int verdict = response ? sink->options->on_headers(response, sink->options->userdata) : -1;
+        http_response_free(response);
+        if (verdict != 0) return -1;
+    }
+
+    int status = sink->reader->status_code;
+    if (status < 200 || status >= 300) {
+        sink->discard = 1;
+        return 0;
+    }
+
+    /* A server ignoring the range (or its If-Range) sends the whole body, if only an empty one */
+    if (sink->ranged && status != 206) {
+        sink->offset = 0;
+        if (http_output_truncate(sink->output, 0) < 0) return -1;
+    }
+    if (sink->reader->content_length > 0 && !sink->reader->decoder &&
+        http_output_reserve(sink->output, sink->offset + (unsigned long long)sink->reader->content_length) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int sink_output(const char *data, size_t len, void *userdata) {
+    OutputSink *sink = userdata;
+    if (sink->discard) return 0;
+    if (http_output_write_at(sink->output, sink->offset, data, len) < 0) return -1;
+    sink->offset += len;
+    return 0;
+}
+
+/* State of an HTTP_SINK_CALLBACK transfer whose response is shown to on_headers first */
+typedef struct {
+    const HttpRequestOptions *options;
+    const HttpReader *reader;     // For the status and headers
+} CheckedSink;
+
+static int check_headers(void *userdata) {
+    CheckedSink *sink = userdata;
+    HttpResponse *response = header_response(sink->reader);
+    int verdict = response ? sink->options->on_headers(response, sink->options->userdata) : -1;
+    http_response_free(response);
+    return verdict;
+}
+
+static int sink_checked(const char *data, size_t len, void *userdata) {
+    CheckedSink *sink = userdata;
+    return sink->options->callback(data, len, sink->options->userdata);
+}
+
+/* Points the reader at the sink the options ask for */
+static int setup_sink(HttpReader *reader, const HttpRequestOptions *options, OutputSink *output_sink,
+                      CheckedSink *checked_sink) {
+    if (!options) return 0;
+    switch (options->sink) {
+    case HTTP_SINK_MEMORY:
+        return 0;
+    case HTTP_SINK_CALLBACK:
+        if (!options->callback) return -1;
+        if (options->on_headers) {
+            checked_sink->options = options;
+            checked_sink->reader = reader;
+            http_reader_stream(reader, sink_checked, checked_sink, options->window);
+            http_reader_on_headers(reader, check_headers);
+            return 0;
+        }
+        http_reader_stream(reader, options->callback, options->userdata, options->window);
+        return 0;
+    case HTTP_SINK_FD:
+        if (options->fd < 0) return -1;
+        http_reader_stream(reader, sink_fd, (void*)&options->fd, options->window);
+        return 0;
+    case HTTP_SINK_FILE:
+        if (!options->file) return -1;
+        http_reader_stream(reader, sink_file, options->file, options->window);
+        return 0;
+    case HTTP_SINK_OUTPUT:
+        if (!options->output) return -1;
+        output_sink->options = options;
+        output_sink->output = options->output;
+        output_sink->offset = options->output_offset;
+        output_sink->reader = reader;
+        output_sink->ranged = options->range != NULL;
+        output_sink->discard = 0;
+        http_reader_stream(reader, sink_output, output_sink, options->window);
+        http_reader_on_headers(reader, settle_output);
+        return 0;
+    }
+    return -1;
+}
+
+/* The descriptor a body may be spliced to, or -1 */
+static int splice_target(const HttpRequestOptions *options) {
+    if (!options || !options->zero_copy) return -1;
+    if (options->sink == HTTP_SINK_FD) return options->fd;
+    if (options->sink == HTTP_SINK_FILE && options->file && fflush(options->file) == 0) return fileno(options->file);
+    return -1;
+}
+
+/* A request body compressed while it is sent, whatever it is read from */
+typedef struct {
+    HttpEncoder *encoder;
+    const char *body;               // Body in memory (NULL if none)
+    size_t body_len;
+    int fd;                         // File the body is read from (-1 if none)
+    unsigned long long fd_offset;   // Where the next read of the file starts
+    HttpBodyProducer producer;      // Caller's producer making the body (NULL if none)
+    void *producer_userdata;
+    char *input;                    // Bytes read from the file or the producer
+    const char *in;                 // Body bytes not compressed yet
+    size_t in_len;
+    int input_done;                 // The last body bytes are in
+    int finished;                   // The last compressed bytes are out
+} EncodedBody;
+
+/* Body bytes read from a file or a producer per compression step */
+#define ENCODER_INPUT_SIZE 65536
+
+/* Starts the body over from its first byte (a memory body needs no reads) */
+static int encoded_body_rewind(EncodedBody *encoded) {
+    encoded->in = encoded->body;
+    encoded->in_len = encoded->body ? encoded->body_len : 0;
+    encoded->input_done = encoded->fd < 0 && !encoded->producer;
+    encoded->fd_offset = 0;
+    encoded->finished = 0;
+    return http_encoder_reset(encoded->encoder);
+}
+
+/* Reads the next body bytes to compress from the file or the producer */
+static int encoded_body_fill(EncodedBody *encoded) {
+    long n;
+    if (encoded->fd >= 0) {
+        do {
+            n = (long)pread(encoded->fd, encoded->input, ENCODER_INPUT_SIZE, (off_t)encoded->fd_offset);
+        } while (n < 0 && errno == EINTR);
+        if (n > 0) encoded->fd_offset += (unsigned long long)n;
     } else {
-        send(sockfd, request, strlen(request), 0);
+        n = encoded->producer(encoded->input, ENCODER_INPUT_SIZE, encoded->producer_userdata);
+        if (n > ENCODER_INPUT_SIZE) n = -1;
     }
+    if (n < 0) return -1;
+    encoded->in = encoded->input;
+    encoded->in_len = (size_t)n;
+    encoded->input_done = n == 0;
+    return 0;
+}
 
-    char *response = malloc(8192);
-    if (!response) {
-        perror("Memory allocation failed");
-        if (use_ssl) {
-            SSL_free(ssl);
-            SSL_CTX_free(ctx);
+/*
+ * Producer of a compressed body: compresses straight into the chunk being
+ * sent, reading the body as the encoder takes it in.
+ */
+static long encode_body(char *buffer, size_t size, void *userdata) {
+    EncodedBody *encoded = userdata;
+    size_t produced = 0;
+    while (produced == 0 && !encoded->finished) {
+        if (!encoded->in_len && !encoded->input_done && encoded_body_fill(encoded) < 0) return -1;
+        produced = size;
+        int status = http_encoder_run(encoded->encoder, &encoded->in, &encoded->in_len, encoded->input_done, buffer, &produced);
+        if (status < 0) return -1;
+        encoded->finished = status == 1;
+    }
+    return (long)produced;
+}
+
+static int encoded_body_init(EncodedBody *encoded, const HttpRequestOptions *options, const char *body, size_t body_len,
+                             int fd, HttpBodyProducer producer, void *producer_userdata) {
+    memset(encoded, 0, sizeof(EncodedBody));
+    encoded->body = body;
+    encoded->body_len = body_len;
+    encoded->fd = fd;
+    encoded->producer = producer;
+    encoded->producer_userdata = producer_userdata;
+    encoded->encoder = http_encoder_new(options->body_coding, options->body_level);
+    if (!encoded->encoder) return -1;
+    if ((fd >= 0 || producer) && !(encoded->input = malloc(ENCODER_INPUT_SIZE))) return -1;
+    return encoded_body_rewind(encoded);
+}
+
+static void encoded_body_free(EncodedBody *encoded) {
+    http_encoder_free(encoded->encoder);
+    free(encoded->input);
+}
+
+static HttpResponse* http_request(const char *url, const char *method, const char *body, int use_ssl,
+                                  const HttpRequestOptions *options) {
+    HttpTarget target;
+    if (http_target_parse(url, use_ssl, &target) < 0) return NULL;
+
+    /* Only the header block is formatted; the body is sent from the caller's memory, file or producer */
+    OutgoingRequest request;
+    request.body_fd = options && options->body_source == HTTP_BODY_FD ? options->body_fd : -1;
+    request.producer = options && options->body_source == HTTP_BODY_PRODUCER ? options->producer : NULL;
+    request.producer_userdata = options ? options->producer_userdata : NULL;
+    request.produced = 0;
+    if (options && options->body_source == HTTP_BODY_PRODUCER && !request.producer) {
+        fprintf(stderr, "Invalid body producer\n");
+        http_target_free(&target);
+        return NULL;
+    }
+    if (request.producer) body = NULL;
+    size_t body_len = options && options->body_len ? options->body_len : body ? strlen(body) : 0;
+    if (request.body_fd >= 0) {
+        struct stat st;
+        if (fstat(request.body_fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+            fprintf(stderr, "Invalid body file\n");
+            http_target_free(&target);
+            return NULL;
         }
-        close(sockfd);
-        url_free(parsed_url);
+        body = NULL;
+        body_len = (size_t)st.st_size;
+    }
+
+    /* A compressed body, wherever it comes from, is made by a producer of our own */
+    EncodedBody encoded;
+    memset(&encoded, 0, sizeof(EncodedBody));
+    if (options && options->body_coding != HTTP_CODING_IDENTITY) {
+        if (encoded_body_init(&encoded, options, body, body_len, request.body_fd, request.producer,
+                              request.producer_userdata) < 0) {
+            fprintf(stderr, "Invalid body coding\n");
+            encoded_body_free(&encoded);
+            http_target_free(&target);
+            return NULL;
+        }
+        request.producer = encode_body;
+        request.producer_userdata = &encoded;
+        request.body_fd = -1;
+        body = NULL;
+    }
+    char head_buffer[4096];
+    char *head = head_buffer;
+    size_t head_len = http_format_head(head, sizeof(head_buffer), &target, method, body_len, options);
+    if (head_len >= sizeof(head_buffer)) {
+        head = malloc(head_len + 1);
+        if (head) http_format_head(head, head_len + 1, &target, method, body_len, options);
+    }
+    if (head_len == 0 || !head) {
+        fprintf(stderr, head ? "Invalid request header\n" : "Memory allocation failed\n");
+        if (head != head_buffer) free(head);
+        encoded_body_free(&encoded);
+        http_target_free(&target);
         return NULL;
     }
+    request.parts[0].iov_base = head;
+    request.parts[0].iov_len = head_len;
+    request.parts[1].iov_base = (void *)body;
+    request.parts[1].iov_len = body ? body_len : 0;
+    request.count = body && body_len > 0 ? 2 : 1;
+    request.body_len = body_len;
 
-    int bytes_received;
-    if (use_ssl) {
-        bytes_received = SSL_read(ssl, response, 8192);
-    } else {
-        bytes_received = recv(sockfd, response, 8192, 0);
+    HttpReader reader;
+    OutputSink output_sink;
+    CheckedSink checked_sink;
+    HttpConnection *conn = NULL;
+    int status = -1;
+    /* A pooled connection may have been closed by the server meanwhile; retry once on a fresh one */
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (http_reader_init(&reader, method) < 0) {
+            perror("Memory allocation failed");
+            break;
+        }
+        if (http_accepts_encoding(method, options)) http_reader_decode(&reader, options ? options->max_decoded : 0);
+        if (setup_sink(&reader, options, &output_sink, &checked_sink) < 0) {
+            fprintf(stderr, "Invalid body sink\n");
+            http_reader_free(&reader);
+            break;
+        }
+
+        PendingConnect pending;
+        const PendingConnect *pending_connect = NULL;
+        conn = http_pool_acquire(target.scheme, target.host, target.port);
+        if (!conn && !use_ssl && http_use_uring() && request.body_fd < 0 && !request.producer) {
+            conn = open_pending_connection(&target, &pending);
+            pending_connect = &pending;
+        }
+        if (!conn) conn = open_connection(target.scheme, target.host, target.port, use_ssl);
+        if (!conn) {
+            http_reader_free(&reader);
+            break;
+        }
+
+        int n = exchange(conn, pending_connect, &request, &reader);
+        status = read_response(conn, &reader, n, splice_target(options));
+        if (reader.too_large) fprintf(stderr, "Decoded body larger than %zu bytes\n", reader.max_decoded);
+        if (reader.len > 0) break;
+
+        int reused = conn->reused;
+        http_connection_close(conn);
+        conn = NULL;
+        http_reader_free(&reader);
+        status = -1;
+        /* What a producer made is gone: it cannot be sent again, unless it
+           compresses a body still at hand */
+        if (!reused || (request.produced && (!encoded.encoder || encoded.producer))) break;
+        if (request.produced && encoded_body_rewind(&encoded) < 0) break;
+        request.produced = 0;
     }
+    http_target_free(&target);
+    if (head != head_buffer) free(head);
+    encoded_body_free(&encoded);
 
-    if (use_ssl) {
-        SSL_free(ssl);
-        SSL_CTX_free(ctx);
+    if (!conn) return NULL;
+
+    if (status > 0 && reader.keep_alive) {
+        http_pool_release(conn);
+    } else {
+        http_connection_close(conn);
     }
-    close(sockfd);
-    url_free(parsed_url);
 
-    HttpResponse *http_response = parse_http_response(response);
-    free(response);
+    /* A truncated response is still handed back, as much of it as arrived,
+       unless part of it already went to a sink that gave up */
+    HttpResponse *http_response = status >= 0 && !reader.sink_failed ? parse_http_response(&reader) : NULL;
+    http_reader_free(&reader);
     return http_response;
 }
 
+int http_set_transport(HttpTransport selected) {
+    if (selected == HTTP_TRANSPORT_IO_URING && !http_uring_available()) {
+        transport = HTTP_TRANSPORT_CLASSIC;
+        return -1;
+    }
+    transport = selected;
+    return 0;
+}
+
+void http_cleanup(void) {
+    http_pool_clear();
+    http_dns_flush();
+    http_tls_cleanup();
+}
+
+HttpResponse* http_request_ex(const char *method, const char *url, const char *body, const HttpRequestOptions *options) {
+    if (!method || !url) return NULL;
+    return http_request(url, method, body, strncmp(url, "https://", 8) == 0, options);
+}
+
 HttpResponse* http_get(const char *url) {
-    return http_request(url, "GET", NULL, strncmp(url, "https://", 8) == 0);
+    return http_request(url, "GET", NULL, strncmp(url, "https://", 8) == 0, NULL);
 }
 
 HttpResponse* http_post(const char *url, const char *body) {
-    return http_request(url, "POST", body, strncmp(url, "https://", 8) == 0);
+    return http_request(url, "POST", body, strncmp(url, "https://", 8) == 0, NULL);
 }
 
 HttpResponse* http_put(const char *url, const char *body) {
-    return http_request(url, "PUT", body, strncmp(url, "https://", 8) == 0);
+    return http_request(url, "PUT", body, strncmp(url, "https://", 8) == 0, NULL);
+}
+
+HttpResponse* http_post_fd(const char *url, int fd) {
+    HttpRequestOptions options = {0};
+    options.body_source = HTTP_BODY_FD;
+    options.body_fd = fd;
+    return http_request(url, "POST", NULL, strncmp(url, "https://", 8) == 0, &options);
+}
+
+HttpResponse* http_put_fd(const char *url, int fd) {
+    HttpRequestOptions options = {0};
+    options.body_source = HTTP_BODY_FD;
+    options.body_fd = fd;
+    return http_request(url, "PUT", NULL, strncmp(url, "https://", 8) == 0, &options);
 }
 
 HttpResponse* http_delete(const char *url) {
-    return http_request(url, "DELETE", NULL, strncmp(url, "https://", 8) == 0);
+    return http_request(url, "DELETE", NULL, strncmp(url, "https://", 8) == 0, NULL);
 }
 
 HttpResponse* http_update(const char *url, const char *body) {
-    return http_request(url, "UPDATE", body, strncmp(url, "https://", 8) == 0);
+    return http_request(url, "UPDATE", body, strncmp(url, "https://", 8) == 0, NULL);
 }
 
 HttpResponse* http_trace(const char *url) {
-    return http_request(url, "TRACE", NULL, strncmp(url, "https://", 8) == 0);
+    return http_request(url, "TRACE", NULL, strncmp(url, "https://", 8) == 0, NULL);
 }
 
 HttpResponse* http_head(const char *url) {
-    return http_request(url, "HEAD", NULL, strncmp(url, "https://", 8) == 0);
+    return http_request(url, "HEAD", NULL, strncmp(url, "https://", 8) == 0, NULL);
 }
 
 HttpResponse* http_options(const char *url) {
-    return http_request(url, "OPTIONS", NULL, strncmp(url, "https://", 8) == 0);
+    return http_request(url, "OPTIONS", NULL, strncmp(url, "https://", 8) == 0, NULL);
 }
 
 HttpResponse* ftp_request(const char *url, const char *command) {
@@ -254,18 +1159,7 @@ HttpResponse* ftp_request(const char *url, const char *command) {
     close(sockfd);
     url_free(parsed_url);
 
-    HttpResponse *http_response = malloc(sizeof(HttpResponse));
-    if (!http_response) {
-        free(response);
-        return NULL;
-    }
-
-    http_response->status_code = 0;
-    http_response->headers = NULL;
-    http_response->body = strndup(response, bytes_received);
-    free(response);
-
-    return http_response;
+    return raw_response(response, bytes_received > 0 ? (size_t)bytes_received : 0);
 }
 
 HttpResponse* telnet_request(const char *url, const char *command) {
@@ -297,36 +1191,19 @@ HttpResponse* telnet_request(const char *url, const char *command) {
     close(sockfd);
     url_free(parsed_url);
 
-    HttpResponse *http_response = malloc(sizeof(HttpResponse));
-    if (!http_response) {
-        free(response);
-        return NULL;
-    }
-
-    http_response->status_code = 0;
-    http_response->headers = NULL;
-    http_response->body = strndup(response, bytes_received);
-    free(response);
-
-    return http_response;
+    return raw_response(response, bytes_received > 0 ? (size_t)bytes_received : 0);
 }
 
 HttpResponse* ssh_request(const char *url, const char *command) {
     // Implement SSH request handling here
     // This is a placeholder implementation
-    HttpResponse *response = malloc(sizeof(HttpResponse));
-    if (!response) return NULL;
+    char *message = strdup("SSH request not implemented");
+    if (!message) return NULL;
 
-    response->status_code = 0;
-    response->headers = NULL;
-    response->body = strdup("SSH request not implemented");
-
-    return response;
+    return raw_response(message, strlen(message));
 }
 
 void http_response_free(HttpResponse *response) {
     if (!response) return;
-    free(response->headers);
-    free(response->body);
-    free(response);
+    free(response->buffer);
 }
@@ -78,7 +78,7 @@ static int connect_to_host(const char *host, int port) {
 static HttpResponse* parse_http_response(const char *response) {
     if (!response) return NULL;
 
-    HttpResponse *http_response = malloc(sizeof(HttpResponse));
+    HttpResponse *http_response = calloc(1, sizeof(HttpResponse));
     if (!http_response) return NULL;
 
     http_response->status_code = 0;
@@ -214,7 +214,7 @@ HttpResponse* ftp_request(const char *url, const char *command) {
     close(sockfd);
     url_free(parsed_url);
 
-    HttpResponse *http_response = malloc(sizeof(HttpResponse));
+    HttpResponse *http_response = calloc(1, sizeof(HttpResponse));
     if (!http_response) {
         free(response);
         return NULL;
@@ -257,7 +257,7 @@ HttpResponse* telnet_request(const char *url, const char *command) {
     close(sockfd);
     url_free(parsed_url);
 
-    HttpResponse *http_response = malloc(sizeof(HttpResponse));
+    HttpResponse *http_response = calloc(1, sizeof(HttpResponse));
     if (!http_response) {
         free(response);
         return NULL;
@@ -301,7 +301,7 @@ HttpResponse* ssh_request(const char *url, const char *command) {
     close(sockfd);
     url_free(parsed_url);
 
-    HttpResponse *http_response = malloc(sizeof(HttpResponse));
+    HttpResponse *http_response = calloc(1, sizeof(HttpResponse));
     if (!http_response) {
         free(response);
         return NULL;
@@ -319,5 +319,6 @@ void http_response_free(HttpResponse *response) {
     if (!response) return;
     free(response->headers);
     free(response->body);
+    free(response->header_fields);
     free(response);
 }
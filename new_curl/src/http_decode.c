@@ -0,0 +1,251 @@
+/**
+ * @file http_decode.c
+ * @brief Implementation of the streaming response body decompression in C.
+ *
+ * This file contains the implementation of the decoders that undo the
+ * Content-Encoding of a response body as it arrives.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Each decoder wraps one zlib or zstd stream, fed whatever slice of the
+ * body the last read brought and writing into the room the caller gives.
+ * Neither library needs its input whole: they keep what a split header or
+ * block left over in their own state. The libraries are optional at build
+ * time (HAVE_ZLIB, HAVE_ZSTD); codings a build lacks are neither asked for
+ * nor decoded.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_decode.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <strings.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+struct HttpDecoder {
+    HttpCoding coding;
+    int started;            // Encoded bytes came in
+    int ended;              // The encoded stream is complete
+#ifdef HAVE_ZLIB
+    z_stream zlib;
+    unsigned char held[2];  // deflate: first bytes, held until they tell whether a zlib wrapper is there
+    size_t held_len;
+    size_t held_pos;        // Held bytes already inflated
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_DStream *zstd;
+#endif
+};
+
+const char* http_decode_accept(void) {
+#if defined(HAVE_ZLIB) && defined(HAVE_ZSTD)
+    return "zstd, gzip, deflate";
+#elif defined(HAVE_ZLIB)
+    return "gzip, deflate";
+#elif defined(HAVE_ZSTD)
+    return "zstd";
+#else
+    return NULL;
+#endif
+}
+
+/* Maps one coding name to its coding */
+static HttpCoding coding_of(const char *name, size_t len) {
+    if (len == 8 && strncasecmp(name, "identity", len) == 0) return HTTP_CODING_IDENTITY;
+#ifdef HAVE_ZLIB
+    if ((len == 4 && strncasecmp(name, "gzip", len) == 0) || (len == 6 && strncasecmp(name, "x-gzip", len) == 0)) {
+        return HTTP_CODING_GZIP;
+    }
+    if (len == 7 && strncasecmp(name, "deflate", len) == 0) return HTTP_CODING_DEFLATE;
+#endif
+#ifdef HAVE_ZSTD
+    if (len == 4 && strncasecmp(name, "zstd", len) == 0) return HTTP_CODING_ZSTD;
+#endif
+    return HTTP_CODING_UNSUPPORTED;
+}
+
+HttpCoding http_decode_coding(const char *value, size_t len) {
+    HttpCoding coding = HTTP_CODING_IDENTITY;
+    const char *end = value + len;
+    while (value < end) {
+        while (value < end && (*value == ' ' || *value == '\t' || *value == ',')) value++;
+        const char *name = value;
+        while (value < end && *value != ',' && *value != ' ' && *value != '\t') value++;
+        if (value == name) break;
+
+        HttpCoding next = coding_of(name, (size_t)(value - name));
+        if (next == HTTP_CODING_IDENTITY) continue;
+        /* Codings applied one over the other are not undone */
+        if (coding != HTTP_CODING_IDENTITY) return HTTP_CODING_UNSUPPORTED;
+        coding = next;
+    }
+    return coding;
+}
+
+HttpDecoder* http_decoder_new(HttpCoding coding) {
+    HttpDecoder *decoder = calloc(1, sizeof(HttpDecoder));
+    if (!decoder) return NULL;
+    decoder->coding = coding;
+
+    switch (coding) {
+#ifdef HAVE_ZLIB
+    case HTTP_CODING_GZIP:
+    case HTTP_CODING_DEFLATE:
+        /* 16 added to the window bits reads the gzip wrapper */
+        if (inflateInit2(&decoder->zlib, coding == HTTP_CODING_GZIP ? MAX_WBITS + 16 : MAX_WBITS) == Z_OK) return decoder;
+        break;
+#endif
+#ifdef HAVE_ZSTD
+    case HTTP_CODING_ZSTD:
+        decoder->zstd = ZSTD_createDStream();
+        if (decoder->zstd && !ZSTD_isError(ZSTD_initDStream(decoder->zstd))) return decoder;
+        ZSTD_freeDStream(decoder->zstd);
+        break;
+#endif
+    default:
+        break;
+    }
+    free(decoder);
+    return NULL;
+}
+
+#ifdef HAVE_ZLIB
+static int inflate_into(HttpDecoder *decoder, const char **in, size_t *in_len, char *out, size_t room, size_t *produced) {
+    z_stream *zlib = &decoder->zlib;
+    for (;;) {
+        if (decoder->ended) {
+            /* Another gzip member may follow; anything else after the end is dropped */
+            if (!*in_len) return 0;
+            if (decoder->coding != HTTP_CODING_GZIP) {
+                *in += *in_len;
+                *in_len = 0;
+                return 0;
+            }
+            if (inflateReset(zlib) != Z_OK) return -1;
+            decoder->ended = 0;
+        }
+
+        uInt in_chunk = *in_len > UINT_MAX ? UINT_MAX : (uInt)*in_len;
+        uInt out_chunk = room - *produced > UINT_MAX ? UINT_MAX : (uInt)(room - *produced);
+        zlib->next_in = (Bytef*)*in;
+        zlib->avail_in = in_chunk;
+        zlib->next_out = (Bytef*)out + *produced;
+        zlib->avail_out = out_chunk;
+        int status = inflate(zlib, Z_NO_FLUSH);
+        size_t used = in_chunk - zlib->avail_in;
+        *in += used;
+        *in_len -= used;
+        *produced += out_chunk - zlib->avail_out;
+
+        if (status == Z_STREAM_END) {
+            decoder->ended = 1;
+            continue;
+        }
+        if (status != Z_OK && status != Z_BUF_ERROR) return -1;
+        if (*produced == room || !*in_len) return 0;
+    }
+}
+
+static int run_zlib(HttpDecoder *decoder, const char **in, size_t *in_len, char *out, size_t room, size_t *produced) {
+    if (decoder->coding == HTTP_CODING_DEFLATE && decoder->held_len < 2) {
+        while (decoder->held_len < 2 && *in_len) {
+            decoder->held[decoder->held_len++] = (unsigned char)**in;
+            (*in)++;
+            (*in_len)--;
+        }
+        if (decoder->held_len < 2) return 0;
+
+        /* A zlib header holds the deflate method and is a multiple of 31;
+           many servers send raw deflate instead */
+        unsigned int header = (unsigned int)decoder->held[0] << 8 | decoder->held[1];
+        if (((decoder->held[0] & 0x0f) != Z_DEFLATED || header % 31 != 0) &&
+            inflateReset2(&decoder->zlib, -MAX_WBITS) != Z_OK) {
+            return -1;
+        }
+    }
+    if (decoder->held_pos < decoder->held_len) {
+        const char *held = (const char*)decoder->held + decoder->held_pos;
+        size_t held_len = decoder->held_len - decoder->held_pos;
+        if (inflate_into(decoder, &held, &held_len, out, room, produced) < 0) return -1;
+        decoder->held_pos = decoder->held_len - held_len;
+        if (held_len) return 0;
+    }
+    return inflate_into(decoder, in, in_len, out, room, produced);
+}
+#endif
+
+#ifdef HAVE_ZSTD
+static int run_zstd(HttpDecoder *decoder, const char **in, size_t *in_len, char *out, size_t room, size_t *produced) {
+    ZSTD_inBuffer input = { *in, *in_len, 0 };
+    ZSTD_outBuffer output = { out, room, 0 };
+    do {
+        /* 0 once a frame is decoded and flushed; a following frame starts a new one */
+        size_t hint = ZSTD_decompressStream(decoder->zstd, &output, &input);
+        if (ZSTD_isError(hint)) return -1;
+        decoder->ended = hint == 0;
+    } while (input.pos < input.size && output.pos < output.size);
+    *in += input.pos;
+    *in_len -= input.pos;
+    *produced = output.pos;
+    return 0;
+}
+#endif
+
+int http_decoder_run(HttpDecoder *decoder, const char **in, size_t *in_len, char *out, size_t *out_len) {
+    size_t room = *out_len;
+    *out_len = 0;
+    if (*in_len) decoder->started = 1;
+
+    switch (decoder->coding) {
+#ifdef HAVE_ZLIB
+    case HTTP_CODING_GZIP:
+    case HTTP_CODING_DEFLATE:
+        return run_zlib(decoder, in, in_len, out, room, out_len);
+#endif
+#ifdef HAVE_ZSTD
+    case HTTP_CODING_ZSTD:
+        return run_zstd(decoder, in, in_len, out, room, out_len);
+#endif
+    default:
+        (void)in;
+        (void)in_len;
+        (void)out;
+        (void)room;
+        return -1;
+    }
+}
+
+int http_decoder_done(const HttpDecoder *decoder) {
+    return !decoder->started || decoder->ended;
+}
+
+void http_decoder_free(HttpDecoder *decoder) {
+    if (!decoder) return;
+#ifdef HAVE_ZLIB
+    if (decoder->coding == HTTP_CODING_GZIP || decoder->coding == HTTP_CODING_DEFLATE) inflateEnd(&decoder->zlib);
+#endif
+#ifdef HAVE_ZSTD
+    if (decoder->coding == HTTP_CODING_ZSTD) ZSTD_freeDStream(decoder->zstd);
+#endif
+    free(decoder);
+}
@@ -0,0 +1,809 @@
+/**
+ * @file http_dns.c
+ * @brief Implementation of the host name resolution and DNS cache in C.
+ *
+ * This file contains the implementation of the resolver the http requests
+ * functions go through to turn a host name into addresses to connect to.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Names are looked up in /etc/hosts first, then asked to the DNS servers
+ * of /etc/resolv.conf by a lookup of our own: the query goes out over UDP
+ * on a non-blocking socket, to the next server when no answer comes in
+ * time, and again over TCP when the answer comes back truncated. The
+ * nameservers, search domains, ndots, timeout and attempts of resolv.conf
+ * are read with res_ninit() and answers are parsed with libresolv, so their
+ * time to live is known. The same lookup either blocks in poll() or is
+ * driven by an event loop. http_dns_set_servers() can replace the servers
+ * of resolv.conf, e.g. with a test server on an unprivileged port.
+ *
+ * getaddrinfo() is used when no resolver configuration can be loaded, and
+ * when the hosts line of /etc/nsswitch.conf lists sources besides files
+ * and dns (mdns, myhostname, nis, ...), which only the system resolver
+ * reaches; those answers are kept DNS_UNTIMED_TTL. Lookups that do not
+ * block then get their answer at once, having waited for it. Answers live
+ * in a hash table under a single lock; lookups run with the lock released.
+ * Only IPv4 addresses are asked for, like everything that connects with
+ * them.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_dns.h"
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <resolv.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <arpa/nameser.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+
+#define DNS_BUCKETS 1024
+#define DNS_MAX_ENTRIES 4096
+#define DNS_MAX_NEGATIVE 256        // Entries for names that do not exist
+#define DNS_MAX_TTL 86400           // Longest an answer is kept, whatever its TTL says
+#define DNS_NEGATIVE_TTL 10         // Longest a name that does not exist stays so
+#define DNS_UNTIMED_TTL 60          // For answers without a TTL (/etc/hosts, getaddrinfo)
+#define DNS_UDP_SIZE 4096           // Largest UDP answer read
+#define DNS_TCP_SIZE (2 + 65535)    // Largest TCP answer, with its length prefix
+
+typedef enum {
+    ENTRY_RESOLVING,    // A thread is looking the name up
+    ENTRY_POSITIVE,     // The name has addresses
+    ENTRY_NEGATIVE      // The name has no IPv4 address
+} EntryState;
+
+typedef struct DnsEntry {
+    struct DnsEntry *next;          // Next entry in the bucket
+    unsigned int hash;              // Hash of the name
+    EntryState state;
+    time_t expires;                 // Monotonic second the answer goes stale at
+    HttpDnsAddresses addresses;     // The answer (positive entries)
+    char name[];                    // Lower-case host name
+} DnsEntry;
+
+/* Outcome of a lookup */
+typedef enum {
+    LOOKUP_FOUND,       // Addresses found
+    LOOKUP_NONE,        // The name surely has no IPv4 address: cached
+    LOOKUP_FAILED       // No answer (unreachable servers, ...): not cached
+} LookupStatus;
+
+struct HttpDnsLookup {
+    char name[NS_MAXDNAME];                         // Cache key: lower-case name, without trailing dot
+    unsigned int hash;
+    char candidates[MAXDNSRCH + 1][NS_MAXDNAME];    // Names to ask for, search domains applied, in order
+    int candidate_count;
+    int candidate;                                  // Candidate being asked for
+    struct sockaddr_in servers[MAXNS];              // Name servers of resolv.conf
+    int server_count;
+    int server;                                     // Server being asked
+    int timeout_ms;                                 // How long to wait for each answer
+    int sends;                                      // Queries sent for the candidate
+    int max_sends;                                  // attempts times servers
+    int fd;                                         // Socket of the query in flight (-1 if none)
+    int tcp;                                        // The query in flight goes over TCP
+    int connecting;                                 // TCP: connect() not completed yet
+    unsigned char query[2 + NS_PACKETSZ];           // Query, after its TCP length prefix
+    size_t query_len;                               // Length of the query, without the prefix
+    size_t sent;                                    // TCP: bytes of the prefixed query written
+    unsigned char *reply;                           // TCP: answer being read, after its length prefix
+    size_t reply_len;                               // TCP: bytes read so far, prefix included
+    int64_t deadline;                               // Monotonic millisecond the answer is late at
+    long negative_ttl;                              // Lowest negative TTL the zones gave
+    int done;
+    LookupStatus status;
+    long ttl;                                       // How long the answer holds
+    HttpDnsAddresses addresses;
+};
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cache_resolved = PTHREAD_COND_INITIALIZER;
+static DnsEntry *buckets[DNS_BUCKETS];
+static size_t entry_count = 0;
+static size_t negative_count = 0;
+
+static pthread_mutex_t servers_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct sockaddr_in set_servers[MAXNS];   // Servers asked instead of those of resolv.conf
+static int set_server_count = 0;
+
+static pthread_once_t nsswitch_once = PTHREAD_ONCE_INIT;
+static int other_sources = 0;   // nsswitch.conf looks hosts up in more than files and DNS
+
+static time_t monotonic_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec;
+}
+
+static int64_t monotonic_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/* FNV-1a */
+static unsigned int hash_name(const char *name) {
+    unsigned int hash = 2166136261u;
+    for (; *name; name++) hash = (hash ^ (unsigned char)*name) * 16777619u;
+    return hash;
+}
+
+/* Names are case-insensitive; a trailing dot makes no difference to the cache */
+static int cache_key(const char *host, char *name) {
+    size_t len = strlen(host);
+    if (len && host[len - 1] == '.') len--;
+    if (len == 0 || len >= NS_MAXDNAME) return -1;
+    for (size_t i = 0; i < len; i++) name[i] = (char)tolower((unsigned char)host[i]);
+    name[len] = '\0';
+    return 0;
+}
+
+/* Looks an entry up; called with cache_lock held */
+static DnsEntry* find_entry(const char *name, unsigned int hash) {
+    for (DnsEntry *entry = buckets[hash % DNS_BUCKETS]; entry; entry = entry->next) {
+        if (entry->hash == hash && strcmp(entry->name, name) == 0) return entry;
+    }
+    return NULL;
+}
+
+/* Unlinks and frees an entry; called with cache_lock held */
+static void remove_entry(DnsEntry *entry) {
+    for (DnsEntry **link = &buckets[entry->hash % DNS_BUCKETS]; *link; link = &(*link)->next) {
+        if (*link == entry) {
+            *link = entry->next;
+            break;
+        }
+    }
+    if (entry->state == ENTRY_NEGATIVE) negative_count--;
+    entry_count--;
+    free(entry);
+}
+
+/*
+ * Makes room for one more entry, of the given state: drops the stale entries
+ * and, if that is not enough, the answer closest to going stale. Entries
+ * being resolved are never dropped. Called with cache_lock held.
+ */
+static void make_room(EntryState state, time_t now) {
+    size_t limit = state == ENTRY_NEGATIVE ? DNS_MAX_NEGATIVE : DNS_MAX_ENTRIES;
+    size_t *count = state == ENTRY_NEGATIVE ? &negative_count : &entry_count;
+    if (*count < limit) return;
+
+    DnsEntry *soonest = NULL;
+    for (size_t i = 0; i < DNS_BUCKETS; i++) {
+        for (DnsEntry *entry = buckets[i], *next; entry; entry = next) {
+            next = entry->next;
+            if (entry->state == ENTRY_RESOLVING) continue;
+            if (entry->expires <= now) {
+                remove_entry(entry);
+            } else if ((state != ENTRY_NEGATIVE || entry->state == ENTRY_NEGATIVE) &&
+                       (!soonest || entry->expires < soonest->expires)) {
+                soonest = entry;
+            }
+        }
+    }
+    if (*count >= limit && soonest) remove_entry(soonest);
+}
+
+/* Adds an entry being resolved; called with cache_lock held */
+static DnsEntry* add_entry(const char *name, unsigned int hash, time_t now) {
+    make_room(ENTRY_RESOLVING, now);
+    size_t len = strlen(name);
+    DnsEntry *entry = malloc(sizeof(DnsEntry) + len + 1);
+    if (!entry) return NULL;
+    memcpy(entry->name, name, len + 1);
+    entry->hash = hash;
+    entry->state = ENTRY_RESOLVING;
+    entry->expires = 0;
+    entry->addresses.count = 0;
+    entry->next = buckets[hash % DNS_BUCKETS];
+    buckets[hash % DNS_BUCKETS] = entry;
+    entry_count++;
+    return entry;
+}
+
+/* Turns an entry being resolved into the answer, or drops it if there is none to keep; called with cache_lock held */
+static void settle_entry(DnsEntry *entry, LookupStatus status, const HttpDnsAddresses *result, long ttl) {
+    time_t now = monotonic_now();
+    if (status == LOOKUP_FAILED) {
+        remove_entry(entry);
+    } else if (status == LOOKUP_NONE) {
+        make_room(ENTRY_NEGATIVE, now);
+        entry->state = ENTRY_NEGATIVE;
+        entry->expires = now + (ttl < 1 ? 1 : ttl < DNS_NEGATIVE_TTL ? ttl : DNS_NEGATIVE_TTL);
+        negative_count++;
+    } else {
+        entry->state = ENTRY_POSITIVE;
+        /* Even an answer with no TTL serves the threads that waited for it */
+        entry->expires = now + (ttl < 1 ? 1 : ttl < DNS_MAX_TTL ? ttl : DNS_MAX_TTL);
+        entry->addresses = *result;
+    }
+}
+
+/*
+ * Looks a name up in the cache. Returns 1 with status set (0 or -1) if a
+ * live answer is there, 0 otherwise. With wait set, a thread resolving the
+ * name is waited for rather than 0 returned. Called with cache_lock held.
+ */
+static int cached(const char *name, unsigned int hash, int wait, HttpDnsAddresses *result, int *status) {
+    DnsEntry *entry;
+    for (;;) {
+        entry = find_entry(name, hash);
+        if (!entry || entry->state != ENTRY_RESOLVING) break;
+        if (!wait) return 0;
+        pthread_cond_wait(&cache_resolved, &cache_lock);
+    }
+    if (!entry || entry->expires <= monotonic_now()) return 0;
+    if (entry->state == ENTRY_POSITIVE) *result = entry->addresses;
+    *status = entry->state == ENTRY_POSITIVE ? 0 : -1;
+    return 1;
+}
+
+/* Keeps the answer of a lookup no thread waits for, unless a thread is resolving the name itself */
+static void store(const char *name, unsigned int hash, LookupStatus status, const HttpDnsAddresses *result, long ttl) {
+    pthread_mutex_lock(&cache_lock);
+    DnsEntry *entry = find_entry(name, hash);
+    if (!entry || entry->state != ENTRY_RESOLVING) {
+        if (entry) remove_entry(entry);
+        if (status != LOOKUP_FAILED && (entry = add_entry(name, hash, monotonic_now()))) {
+            settle_entry(entry, status, result, ttl);
+        }
+    }
+    pthread_mutex_unlock(&cache_lock);
+}
+
+static void add_address(HttpDnsAddresses *result, struct in_addr address) {
+    for (size_t i = 0; i < result->count; i++) {
+        if (result->addresses[i].s_addr == address.s_addr) return;
+    }
+    if (result->count < HTTP_DNS_MAX_ADDRESSES) result->addresses[result->count++] = address;
+}
+
+/* Collects the IPv4 addresses /etc/hosts lists for a name */
+static LookupStatus lookup_hosts_file(const char *name, HttpDnsAddresses *result) {
+    FILE *file = fopen("/etc/hosts", "re");
+    if (!file) return LOOKUP_FAILED;
+
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "#\n")] = '\0';
+        char *save;
+        char *field = strtok_r(line, " \t", &save);
+        struct in_addr address;
+        if (!field || inet_pton(AF_INET, field, &address) != 1) continue;
+        while ((field = strtok_r(NULL, " \t", &save))) {
+            if (strcasecmp(field, name) == 0) {
+                add_address(result, address);
+                break;
+            }
+        }
+    }
+    fclose(file);
+    return result->count ? LOOKUP_FOUND : LOOKUP_FAILED;
+}
+
+/* Notes whether the hosts line of nsswitch.conf names sources besides files and dns */
+static void read_nsswitch(void) {
+    FILE *file = fopen("/etc/nsswitch.conf", "re");
+    if (!file) return;
+
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "#\n")] = '\0';
+        char *sources = line + strspn(line, " \t");
+        if (strncmp(sources, "hosts", 5) != 0) continue;
+        sources += 5 + strspn(sources + 5, " \t");
+        if (*sources != ':') continue;
+
+        char *save;
+        for (char *field = strtok_r(sources + 1, " \t", &save); field; field = strtok_r(NULL, " \t", &save)) {
+            /* [NOTFOUND=return] and the like are actions, not sources */
+            if (field[0] == '[') continue;
+            if (strcmp(field, "files") != 0 && strcmp(field, "dns") != 0) other_sources = 1;
+        }
+    }
+    fclose(file);
+}
+
+/* Tells whether only the system resolver may answer: it alone asks the other
+   sources nsswitch.conf lists, unless servers were set */
+static int system_only(void) {
+    pthread_once(&nsswitch_once, read_nsswitch);
+    pthread_mutex_lock(&servers_lock);
+    int only = other_sources && !set_server_count;
+    pthread_mutex_unlock(&servers_lock);
+    return only;
+}
+
+/* Resolves through the system resolver, which leaves the TTL unknown */
+static LookupStatus lookup_system(const char *name, HttpDnsAddresses *result) {
+    struct addrinfo hints = {0};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *list;
+    int status = getaddrinfo(name, NULL, &hints, &list);
+    if (status == EAI_NONAME) return LOOKUP_NONE;
+    if (status != 0) return LOOKUP_FAILED;
+
+    for (struct addrinfo *info = list; info; info = info->ai_next) {
+        add_address(result, ((struct sockaddr_in*)info->ai_addr)->sin_addr);
+    }
+    freeaddrinfo(list);
+    return result->count ? LOOKUP_FOUND : LOOKUP_NONE;
+}
+
+/* Appends a name to ask for, joined to a search domain if given */
+static void add_candidate(HttpDnsLookup *lookup, const char *name, const char *domain) {
+    char *candidate = lookup->candidates[lookup->candidate_count];
+    int len = domain ? snprintf(candidate, NS_MAXDNAME, "%s.%s", name, domain)
+                     : snprintf(candidate, NS_MAXDNAME, "%s", name);
+    if (len > 0 && len < NS_MAXDNAME) lookup->candidate_count++;
+}
+
+/* Writes the A query for the current candidate, under a fresh random id */
+static int build_query(HttpDnsLookup *lookup) {
+    unsigned char *query = lookup->query + 2;
+    uint16_t id;
+    if (getrandom(&id, sizeof(id), GRND_NONBLOCK) != sizeof(id)) id = (uint16_t)(monotonic_ms() ^ (uintptr_t)lookup);
+    /* id, recursion desired, one question */
+    const unsigned char header[NS_HFIXEDSZ] = { id >> 8, id & 0xff, 0x01, 0x00, 0, 1, 0, 0, 0, 0, 0, 0 };
+    memcpy(query, header, sizeof(header));
+    size_t len = sizeof(header);
+
+    const char *label = lookup->candidates[lookup->candidate];
+    while (*label) {
+        size_t label_len = strcspn(label, ".");
+        if (label_len == 0 || label_len > NS_MAXLABEL || len + 1 + label_len + 5 > NS_PACKETSZ) return -1;
+        query[len++] = (unsigned char)label_len;
+        memcpy(query + len, label, label_len);
+        len += label_len;
+        label += label_len;
+        if (*label == '.') label++;
+    }
+    /* Root label, type A, class IN */
+    const unsigned char tail[5] = { 0, 0, ns_t_a, 0, ns_c_in };
+    memcpy(query + len, tail, sizeof(tail));
+    len += sizeof(tail);
+
+    lookup->query[0] = (unsigned char)(len >> 8);
+    lookup->query[1] = (unsigned char)(len & 0xff);
+    lookup->query_len = len;
+    return 0;
+}
+
+static void close_socket(HttpDnsLookup *lookup) {
+    if (lookup->fd >= 0) close(lookup->fd);
+    lookup->fd = -1;
+    lookup->tcp = 0;
+    lookup->connecting = 0;
+    free(lookup->reply);
+    lookup->reply = NULL;
+}
+
+/* Ends the lookup; returns 1 for the callers to pass on */
+static int finish(HttpDnsLookup *lookup, LookupStatus status) {
+    close_socket(lookup);
+    lookup->done = 1;
+    lookup->status = status;
+    if (status == LOOKUP_NONE) lookup->ttl = lookup->negative_ttl;
+    return 1;
+}
+
+/* Sends the query over UDP to the current server */
+static int send_udp(HttpDnsLookup *lookup) {
+    close_socket(lookup);
+    lookup->sends++;
+    lookup->deadline = monotonic_ms() + lookup->timeout_ms;
+    if (build_query(lookup) < 0) return -1;
+
+    /* A connected socket only hears from the server it asked */
+    lookup->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (lookup->fd < 0 ||
+        connect(lookup->fd, (struct sockaddr*)&lookup->servers[lookup->server], sizeof(lookup->servers[0])) < 0 ||
+        send(lookup->fd, lookup->query + 2, lookup->query_len, MSG_NOSIGNAL) != (ssize_t)lookup->query_len) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Asks the current server, or the next ones if it cannot be asked; returns 1 once every attempt is spent */
+static int ask_server(HttpDnsLookup *lookup) {
+    while (send_udp(lookup) < 0) {
+        if (lookup->sends >= lookup->max_sends) return finish(lookup, LOOKUP_FAILED);
+        lookup->server = (lookup->server + 1) % lookup->server_count;
+    }
+    return 0;
+}
+
+/* Gives up on the current server for the next one; returns 1 once every attempt is spent */
+static int next_server(HttpDnsLookup *lookup) {
+    if (lookup->sends >= lookup->max_sends) return finish(lookup, LOOKUP_FAILED);
+    lookup->server = (lookup->server + 1) % lookup->server_count;
+    return ask_server(lookup);
+}
+
+/* The current candidate does not exist: asks for the next one; returns 1 if none is left */
+static int next_candidate(HttpDnsLookup *lookup) {
+    if (++lookup->candidate >= lookup->candidate_count) return finish(lookup, LOOKUP_NONE);
+    lookup->sends = 0;
+    lookup->server = 0;
+    return ask_server(lookup);
+}
+
+/* Asks the current server again over TCP, the answer not fitting in UDP */
+static int ask_over_tcp(HttpDnsLookup *lookup) {
+    close_socket(lookup);
+    lookup->deadline = monotonic_ms() + lookup->timeout_ms;
+    lookup->tcp = 1;
+    lookup->sent = 0;
+    lookup->reply_len = 0;
+    lookup->reply = malloc(DNS_TCP_SIZE);
+    if (!lookup->reply) return finish(lookup, LOOKUP_FAILED);
+
+    lookup->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (lookup->fd < 0) return next_server(lookup);
+    if (connect(lookup->fd, (struct sockaddr*)&lookup->servers[lookup->server], sizeof(lookup->servers[0])) < 0) {
+        if (errno != EINPROGRESS) return next_server(lookup);
+        lookup->connecting = 1;
+    }
+    return 0;
+}
+
+/* Lowers the negative TTL to what the SOA record of a negative answer allows */
+static void note_negative_ttl(HttpDnsLookup *lookup, ns_msg *message) {
+    for (int i = 0; i < ns_msg_count(*message, ns_s_ns); i++) {
+        ns_rr record;
+        if (ns_parserr(message, ns_s_ns, i, &record) < 0 || ns_rr_type(record) != ns_t_soa) continue;
+        /* The minimum comes after the two names and the serial, refresh, retry and expire fields */
+        const unsigned char *field = ns_rr_rdata(record);
+        const unsigned char *end = field + ns_rr_rdlen(record);
+        for (int names = 0; names < 2 && field; names++) {
+            int len = dn_skipname(field, end);
+            field = len < 0 ? NULL : field + len;
+        }
+        if (!field || end - field < 20) continue;
+        long ttl = (long)ns_rr_ttl(record);
+        long minimum = (long)ns_get32(field + 16);
+        if (minimum < ttl) ttl = minimum;
+        if (ttl < lookup->negative_ttl) lookup->negative_ttl = ttl;
+    }
+}
+
+/*
+ * Acts on an answer. Returns -1 if it is not the answer to the query in
+ * flight, 1 once the lookup is over, 0 if it goes on.
+ */
+static int handle_answer(HttpDnsLookup *lookup, const unsigned char *answer, size_t len) {
+    ns_msg message;
+    ns_rr question;
+    if (len < NS_HFIXEDSZ || memcmp(answer, lookup->query + 2, 2) != 0 || !(answer[2] & 0x80) ||
+        ns_initparse(answer, (int)len, &message) < 0 || ns_msg_count(message, ns_s_qd) != 1 ||
+        ns_parserr(&message, ns_s_qd, 0, &question) < 0 ||
+        strcasecmp(ns_rr_name(question), lookup->candidates[lookup->candidate]) != 0) {
+        return -1;
+    }
+    if (ns_msg_getflag(message, ns_f_tc) && !lookup->tcp) return ask_over_tcp(lookup);
+
+    switch (ns_msg_getflag(message, ns_f_rcode)) {
+    case ns_r_noerror:
+        break;
+    case ns_r_nxdomain:
+        note_negative_ttl(lookup, &message);
+        return next_candidate(lookup);
+    default:
+        /* SERVFAIL, REFUSED, ...: another server may know better */
+        return next_server(lookup);
+    }
+
+    /* The lowest TTL of the A records, and of the CNAME records that led to them */
+    long ttl = DNS_MAX_TTL;
+    for (int i = 0; i < ns_msg_count(message, ns_s_an); i++) {
+        ns_rr record;
+        if (ns_parserr(&message, ns_s_an, i, &record) < 0) return next_server(lookup);
+        if (ns_rr_type(record) != ns_t_a && ns_rr_type(record) != ns_t_cname) continue;
+        if ((long)ns_rr_ttl(record) < ttl) ttl = (long)ns_rr_ttl(record);
+        if (ns_rr_type(record) == ns_t_a && ns_rr_rdlen(record) == sizeof(struct in_addr)) {
+            struct in_addr address;
+            memcpy(&address, ns_rr_rdata(record), sizeof(address));
+            add_address(&lookup->addresses, address);
+        }
+    }
+    if (!lookup->addresses.count) {
+        /* The name exists, without an A record */
+        note_negative_ttl(lookup, &message);
+        return next_candidate(lookup);
+    }
+    lookup->ttl = ttl;
+    return finish(lookup, LOOKUP_FOUND);
+}
+
+/* Moves a TCP query on: completes the connection, writes the query, reads the answer */
+static int run_tcp(HttpDnsLookup *lookup) {
+    if (lookup->connecting) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(lookup->fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) return next_server(lookup);
+        if (err == EINPROGRESS || err == EALREADY) return 0;
+        if (err) return next_server(lookup);
+        lookup->connecting = 0;
+    }
+    while (lookup->sent < lookup->query_len + 2) {
+        ssize_t n = send(lookup->fd, lookup->query + lookup->sent, lookup->query_len + 2 - lookup->sent, MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : next_server(lookup);
+        lookup->sent += (size_t)n;
+    }
+
+    /* Two bytes of length, then the answer */
+    for (;;) {
+        size_t want = lookup->reply_len < 2 ? 2 : 2 + ((size_t)lookup->reply[0] << 8 | lookup->reply[1]);
+        if (lookup->reply_len == want) break;
+        ssize_t n = recv(lookup->fd, lookup->reply + lookup->reply_len, want - lookup->reply_len, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        if (n <= 0) return next_server(lookup);
+        lookup->reply_len += (size_t)n;
+    }
+    int ret = handle_answer(lookup, lookup->reply + 2, lookup->reply_len - 2);
+    return ret < 0 ? next_server(lookup) : ret;
+}
+
+/* Moves a lookup on after its socket got ready or its time ran out; returns 1 once it is over */
+static int lookup_run(HttpDnsLookup *lookup) {
+    if (lookup->done) return 1;
+
+    if (lookup->tcp) {
+        if (run_tcp(lookup)) return 1;
+    } else {
+        unsigned char answer[DNS_UDP_SIZE];
+        for (;;) {
+            ssize_t n = recv(lookup->fd, answer, sizeof(answer), 0);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            /* ECONNREFUSED: nothing listens on the server's port */
+            if (n < 0) return next_server(lookup);
+            int ret = handle_answer(lookup, answer, (size_t)n);
+            if (ret >= 0) return ret;
+        }
+    }
+    return monotonic_ms() >= lookup->deadline ? next_server(lookup) : 0;
+}
+
+/* Starts a DNS lookup for a name; NULL if the resolver configuration cannot be loaded */
+static HttpDnsLookup* lookup_new(const char *host, const char *name, unsigned int hash) {
+    HttpDnsLookup *lookup = calloc(1, sizeof(HttpDnsLookup));
+    if (!lookup) return NULL;
+    lookup->fd = -1;
+    strcpy(lookup->name, name);
+    lookup->hash = hash;
+    lookup->negative_ttl = DNS_NEGATIVE_TTL;
+
+    struct __res_state state;
+    memset(&state, 0, sizeof(state));
+    if (res_ninit(&state) < 0) {
+        res_nclose(&state);
+        free(lookup);
+        return NULL;
+    }
+    pthread_mutex_lock(&servers_lock);
+    if (set_server_count) {
+        memcpy(lookup->servers, set_servers, sizeof(set_servers));
+        lookup->server_count = set_server_count;
+    } else {
+        for (int i = 0; i < state.nscount && i < MAXNS; i++) {
+            if (state.nsaddr_list[i].sin_family == AF_INET) lookup->servers[lookup->server_count++] = state.nsaddr_list[i];
+        }
+    }
+    pthread_mutex_unlock(&servers_lock);
+    lookup->timeout_ms = (state.retrans > 0 ? state.retrans : RES_TIMEOUT) * 1000;
+    lookup->max_sends = (state.retry > 0 ? state.retry : 1) * lookup->server_count;
+
+    /* Like the system resolver: a name with ndots dots or more is tried as it is before
+       the search domains, one with fewer after them, and one ending with a dot only as it is */
+    int dots = 0;
+    for (const char *c = name; *c; c++) dots += *c == '.';
+    if (host[strlen(host) - 1] == '.') {
+        add_candidate(lookup, name, NULL);
+    } else {
+        if (dots >= (int)state.ndots) add_candidate(lookup, name, NULL);
+        for (int i = 0; i < MAXDNSRCH && state.dnsrch[i]; i++) add_candidate(lookup, name, state.dnsrch[i]);
+        if (dots < (int)state.ndots) add_candidate(lookup, name, NULL);
+    }
+    res_nclose(&state);
+
+    if (!lookup->server_count || !lookup->candidate_count) {
+        free(lookup);
+        return NULL;
+    }
+    ask_server(lookup);
+    return lookup;
+}
+
+/* Looks a name up, from the hosts file then DNS, waiting for the answer, and tells how long it holds */
+static LookupStatus lookup(const char *host, const char *name, unsigned int hash, HttpDnsAddresses *result, long *ttl) {
+    *ttl = DNS_UNTIMED_TTL;
+    if (lookup_hosts_file(name, result) == LOOKUP_FOUND) return LOOKUP_FOUND;
+    if (system_only()) return lookup_system(name, result);
+
+    HttpDnsLookup *dns = lookup_new(host, name, hash);
+    if (!dns) return lookup_system(name, result);
+    while (!lookup_run(dns)) {
+        int want_write;
+        struct pollfd pfd = { .fd = http_dns_lookup_fd(dns, &want_write) };
+        pfd.events = want_write ? POLLOUT : POLLIN;
+        if (poll(&pfd, 1, http_dns_lookup_timeout(dns)) < 0 && errno != EINTR) {
+            finish(dns, LOOKUP_FAILED);
+        }
+    }
+    LookupStatus status = dns->status;
+    *result = dns->addresses;
+    *ttl = dns->ttl;
+    http_dns_lookup_free(dns);
+    return status;
+}
+
+int http_dns_resolve(const char *host, HttpDnsAddresses *result) {
+    result->count = 0;
+    if (inet_pton(AF_INET, host, &result->addresses[0]) == 1) {
+        result->count = 1;
+        return 0;
+    }
+
+    char name[NS_MAXDNAME];
+    if (cache_key(host, name) < 0) return -1;
+    unsigned int hash = hash_name(name);
+
+    pthread_mutex_lock(&cache_lock);
+    int status;
+    if (cached(name, hash, 1, result, &status)) {
+        pthread_mutex_unlock(&cache_lock);
+        return status;
+    }
+    DnsEntry *entry = find_entry(name, hash);
+    if (entry) remove_entry(entry);
+    entry = add_entry(name, hash, monotonic_now());
+    pthread_mutex_unlock(&cache_lock);
+    if (!entry) return -1;
+
+    long ttl;
+    LookupStatus found = lookup(host, name, hash, result, &ttl);
+
+    pthread_mutex_lock(&cache_lock);
+    settle_entry(entry, found, result, ttl);
+    pthread_cond_broadcast(&cache_resolved);
+    pthread_mutex_unlock(&cache_lock);
+    return found == LOOKUP_FOUND ? 0 : -1;
+}
+
+int http_dns_lookup_start(const char *host, HttpDnsAddresses *result, HttpDnsLookup **lookup) {
+    *lookup = NULL;
+    result->count = 0;
+    if (inet_pton(AF_INET, host, &result->addresses[0]) == 1) {
+        result->count = 1;
+        return 0;
+    }
+
+    char name[NS_MAXDNAME];
+    if (cache_key(host, name) < 0) return -1;
+    unsigned int hash = hash_name(name);
+
+    /* Waiting for a thread resolving the name would block the caller's loop */
+    pthread_mutex_lock(&cache_lock);
+    int status;
+    int hit = cached(name, hash, 0, result, &status);
+    pthread_mutex_unlock(&cache_lock);
+    if (hit) return status;
+
+    if (lookup_hosts_file(name, result) == LOOKUP_FOUND) {
+        store(name, hash, LOOKUP_FOUND, result, DNS_UNTIMED_TTL);
+        return 0;
+    }
+    /* Names only the system resolver may answer are resolved right away, blocking like it */
+    HttpDnsLookup *dns = system_only() ? NULL : lookup_new(host, name, hash);
+    if (!dns) {
+        LookupStatus found = lookup_system(name, result);
+        store(name, hash, found, result, DNS_UNTIMED_TTL);
+        return found == LOOKUP_FOUND ? 0 : -1;
+    }
+    if (dns->done) {
+        http_dns_lookup_free(dns);
+        return -1;
+    }
+    *lookup = dns;
+    return 0;
+}
+
+int http_dns_lookup_fd(const HttpDnsLookup *lookup, int *want_write) {
+    if (want_write) *want_write = lookup->tcp && (lookup->connecting || lookup->sent < lookup->query_len + 2);
+    return lookup->fd;
+}
+
+int http_dns_lookup_timeout(const HttpDnsLookup *lookup) {
+    if (lookup->done) return 0;
+    int64_t left = lookup->deadline - monotonic_ms();
+    return left <= 0 ? 0 : left > INT_MAX ? INT_MAX : (int)left;
+}
+
+int http_dns_lookup_process(HttpDnsLookup *lookup, HttpDnsAddresses *result) {
+    if (!lookup_run(lookup)) return 0;
+    store(lookup->name, lookup->hash, lookup->status, &lookup->addresses, lookup->ttl);
+    if (lookup->status != LOOKUP_FOUND) return -1;
+    *result = lookup->addresses;
+    return 1;
+}
+
+void http_dns_lookup_free(HttpDnsLookup *lookup) {
+    if (!lookup) return;
+    close_socket(lookup);
+    free(lookup);
+}
+
+int http_dns_set_servers(const char *servers) {
+    struct sockaddr_in parsed[MAXNS];
+    int count = 0;
+    memset(parsed, 0, sizeof(parsed));
+
+    /* "address[:port]" items, separated by commas */
+    for (const char *item = servers; item && *item; ) {
+        size_t len = strcspn(item, ",");
+        char text[64];
+        if (len == 0 || len >= sizeof(text) || count == MAXNS) return -1;
+        memcpy(text, item, len);
+        text[len] = '\0';
+        item += len + (item[len] == ',');
+
+        long port = NS_DEFAULTPORT;
+        char *colon = strchr(text, ':');
+        if (colon) {
+            char *end;
+            *colon = '\0';
+            port = strtol(colon + 1, &end, 10);
+            if (end == colon + 1 || *end != '\0' || port < 1 || port > 65535) return -1;
+        }
+        parsed[count].sin_family = AF_INET;
+        parsed[count].sin_port = htons((uint16_t)port);
+        if (inet_pton(AF_INET, text, &parsed[count].sin_addr) != 1) return -1;
+        count++;
+    }
+
+    pthread_mutex_lock(&servers_lock);
+    memcpy(set_servers, parsed, sizeof(parsed));
+    set_server_count = count;
+    pthread_mutex_unlock(&servers_lock);
+    return 0;
+}
+
+void http_dns_flush(void) {
+    pthread_mutex_lock(&cache_lock);
+    for (size_t i = 0; i < DNS_BUCKETS; i++) {
+        for (DnsEntry *entry = buckets[i], *next; entry; entry = next) {
+            next = entry->next;
+            /* A lookup in progress still owns its entry */
+            if (entry->state != ENTRY_RESOLVING) remove_entry(entry);
+        }
+    }
+    pthread_mutex_unlock(&cache_lock);
+}
@@ -0,0 +1,575 @@
+/**
+ * @file http_download.c
+ * @brief Implementation of the parallel segmented downloads in C.
+ *
+ * This file contains the implementation of downloads fetching an object as
+ * byte ranges over parallel connections, written at their offsets in the
+ * output file.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Workers take the next range from a shared cursor; each sizes its ranges
+ * so that one takes about SEGMENT_SECONDS at the rate its last range was
+ * fetched. The calling thread measures the total throughput every
+ * RAMP_INTERVAL_MS and starts one more worker as long as the previous one
+ * raised it by RAMP_GAIN or more. Ranges that fail are queued again from
+ * their first missing byte, after a delay when the server refused them for
+ * now, and given up after MAX_ATTEMPTS failures in a row. A response is
+ * checked to hold the range asked for before any of its bytes is written.
+ *
+ * A resumed download writes to a file opened with HTTP_OUTPUT_KEEP, whose
+ * size is what it holds. A fresh one first sends a HEAD for the validator
+ * and saves it before any byte is written, so that a run killed midway can
+ * still be resumed safely; a partial file without a saved validator is
+ * resumed without If-Range. Every request asks for the identity body, so
+ * that the file size, the ranges and the announced lengths all count the
+ * same bytes. A 206 is checked to start where the file ends before any of
+ * its bytes is written; one that does not gets the file fetched again from
+ * the start. A body without a length, chunked or delimited by the close,
+ * is the rest of the object once it ran to its end.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_download.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_STREAMS 8
+#define DEFAULT_MIN_SEGMENT (256 * 1024)
+#define DEFAULT_MAX_SEGMENT (64 * 1024 * 1024)
+#define INITIAL_STREAMS 2
+#define SEGMENT_SECONDS 2.0
+#define RAMP_INTERVAL_MS 500
+#define RAMP_GAIN 1.1
+#define MAX_ATTEMPTS 5
+#define RETRY_DELAY_MS 500
+#define RESUME_SUFFIX ".resume"
+#define MAX_VALIDATOR 256
+
+/* A byte range [start, end) still to fetch */
+typedef struct {
+    unsigned long long start;
+    unsigned long long end;
+    int attempts;         // Failures in a row
+} Segment;
+
+typedef struct {
+    const char *url;
+    HttpOutput *output;
+    unsigned long long size;
+    unsigned long long min_segment;
+    unsigned long long max_segment;
+    unsigned long long first_segment;   // Size of the first range of each worker
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;     // Signalled when a worker exits
+    unsigned long long next;    // First byte not handed out yet
+    Segment *retry;             // Ranges to fetch again
+    size_t retry_count;
+    size_t retry_cap;
+    size_t active;              // Running workers
+    int failed;
+    HttpDownloadStats stats;
+
+    unsigned long long received;    // Bytes written so far (updated atomically)
+} Download;
+
+/* Writes a range at its offset */
+typedef struct {
+    Download *download;
+    unsigned long long offset;  // Where the next byte goes
+    unsigned long long end;
+    int status;                 // Status of the response, once its headers are in
+    int range_ok;               // The response holds the range asked for
+} SegmentSink;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Parses a decimal header value, which is a span followed by CRLF */
+static int header_number(const HttpHeader *header, unsigned long long *value) {
+    char digits[32];
+    if (!header || header->value_len == 0 || header->value_len >= sizeof(digits)) return -1;
+    memcpy(digits, header->value, header->value_len);
+    digits[header->value_len] = '\0';
+
+    char *end;
+    *value = strtoull(digits, &end, 10);
+    return *end == '\0' && digits[0] != '-' ? 0 : -1;
+}
+
+/* Checks that a 206 response holds the range that was asked for */
+static int content_range_starts_at(const HttpResponse *response, unsigned long long start) {
+    const HttpHeader *header = http_response_header_id(response, HTTP_HEADER_CONTENT_RANGE);
+    if (!header || header->value_len < 7 || strncasecmp(header->value, "bytes ", 6) != 0) return 0;
+
+    unsigned long long first = 0;
+    size_t i = 6;
+    if (header->value[i] < '0' || header->value[i] > '9') return 0;
+    while (i < header->value_len && header->value[i] >= '0' && header->value[i] <= '9') {
+        first = first * 10 + (unsigned long long)(header->value[i++] - '0');
+    }
+    return first == start && i < header->value_len && header->value[i] == '-';
+}
+
+/* Lets the body through only if it is the range asked for, before any byte of it is written */
+static int check_segment(const HttpResponse *response, void *userdata) {
+    SegmentSink *sink = userdata;
+    sink->status = response->status_code;
+    sink->range_ok = response->status_code == 206 && content_range_starts_at(response, sink->offset);
+    return sink->range_ok ? 0 : -1;
+}
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static int sink_segment(const char *data, size_t len, void *userdata) {
+    SegmentSink *sink = userdata;
+    /* More bytes than asked for: the server sent something else than the range */
+    if (len > sink->end - sink->offset) return -1;
+    if (http_output_write_at(sink->download->output, sink->offset, data, len) < 0) return -1;
+    sink->offset += len;
+    __atomic_add_fetch(&sink->download->received, len, __ATOMIC_RELAXED);
+    return 0;
+}
+
+/* Hands out the next range to fetch; returns 0 when there is none left */
+static int take_segment(Download *download, unsigned long long segment_size, Segment *segment) {
+    int found = 0;
+    pthread_mutex_lock(&download->lock);
+    if (download->failed) {
+        found = 0;
+    } else if (download->retry_count > 0) {
+        *segment = download->retry[--download->retry_count];
+        found = 1;
+    } else if (download->next < download->size) {
+        segment->start = download->next;
+        segment->end = download->size - download->next > segment_size ? download->next + segment_size : download->size;
+        segment->attempts = 0;
+        download->next = segment->end;
+        found = 1;
+    }
+    pthread_mutex_unlock(&download->lock);
+    return found;
+}
+
+/* Queues the rest of a failed range, or fails the download after too many attempts */
+static void requeue_segment(Download *download, const Segment *segment, int give_up) {
+    pthread_mutex_lock(&download->lock);
+    download->stats.retries++;
+    if (give_up || segment->attempts >= MAX_ATTEMPTS) {
+        download->failed = 1;
+    } else if (download->retry_count == download->retry_cap) {
+        size_t cap = download->retry_cap ? download->retry_cap * 2 : 8;
+        Segment *retry = realloc(download->retry, cap * sizeof(Segment));
+        if (!retry) {
+            download->failed = 1;
+        } else {
+            download->retry = retry;
+            download->retry_cap = cap;
+        }
+    }
+    if (!download->failed) download->retry[download->retry_count++] = *segment;
+    pthread_mutex_unlock(&download->lock);
+}
+
+/*
+ * Fetches one range. Returns 1 if it completed, 0 if it should be fetched
+ * again from segment->start (updated to the first missing byte), and -1
+ * if the server does not serve the range at all.
+ */
+static int fetch_segment(Download *download, Segment *segment) {
+    char range[64];
+    snprintf(range, sizeof(range), "bytes=%llu-%llu", segment->start, segment->end - 1);
+
+    SegmentSink sink = { download, segment->start, segment->end, 0, 0 };
+    HttpRequestOptions options = {0};
+    options.sink = HTTP_SINK_CALLBACK;
+    options.callback = sink_segment;
+    options.on_headers = check_segment;
+    options.userdata = &sink;
+    options.range = range;
+
+    HttpResponse *response = http_request_ex("GET", download->url, NULL, &options);
+    /* An aborted transfer returns no response, but its headers were seen */
+    int status = response ? response->status_code : sink.status;
+    int range_ok = response ? status == 206 && content_range_starts_at(response, segment->start) : sink.range_ok;
+    int result;
+    if (status == 200 || (status == 206 && !range_ok)) {
+        /* The server ignores the range */
+        result = -1;
+    } else if (response && status == 206 && sink.offset == segment->end) {
+        result = 1;
+    } else {
+        /* Cut short, or refused for now (a 5xx or a 429): only what is missing is asked for again */
+        if (sink.offset > segment->start) segment->attempts = 0;
+        segment->start = sink.offset;
+        segment->attempts++;
+        if (status != 0 && status != 206) sleep_ms(RETRY_DELAY_MS * segment->attempts);
+        result = 0;
+    }
+    http_response_free(response);
+    return result;
+}
+
+static void* download_worker(void *arg) {
+    Download *download = arg;
+    unsigned long long segment_size = download->first_segment;
+
+    Segment segment;
+    while (take_segment(download, segment_size, &segment)) {
+        unsigned long long start = segment.start;
+        double started = now_seconds();
+        int result = fetch_segment(download, &segment);
+        if (result < 0) {
+            requeue_segment(download, &segment, 1);
+            break;
+        }
+        if (result == 0) {
+            requeue_segment(download, &segment, 0);
+            continue;
+        }
+
+        pthread_mutex_lock(&download->lock);
+        download->stats.segments++;
+        pthread_mutex_unlock(&download->lock);
+
+        /* Size the next range after the rate of this stream */
+        double elapsed = now_seconds() - started;
+        if (elapsed > 0.001) {
+            double next_size = (double)(segment.end - start) / elapsed * SEGMENT_SECONDS;
+            segment_size = next_size < download->min_segment ? download->min_segment
+                         : next_size > download->max_segment ? download->max_segment
+                         : (unsigned long long)next_size;
+        }
+    }
+
+    pthread_mutex_lock(&download->lock);
+    download->active--;
+    pthread_cond_signal(&download->changed);
+    pthread_mutex_unlock(&download->lock);
+    return NULL;
+}
+
+/* Starts one more worker; called with the lock held */
+static int start_worker(Download *download, pthread_t *threads, size_t *started) {
+    if (pthread_create(&threads[*started], NULL, download_worker, download) != 0) return -1;
+    (*started)++;
+    download->active++;
+    if (download->active > download->stats.peak_streams) download->stats.peak_streams = download->active;
+    return 0;
+}
+
+/* Runs the workers, adding streams while they raise the throughput */
+static void run_segmented(Download *download, size_t max_streams) {
+    pthread_t *threads = malloc(max_streams * sizeof(pthread_t));
+    if (!threads) {
+        download->failed = 1;
+        return;
+    }
+
+    size_t started = 0;
+    pthread_mutex_lock(&download->lock);
+    for (size_t i = 0; i < INITIAL_STREAMS && i < max_streams; i++) {
+        if (start_worker(download, threads, &started) < 0) break;
+    }
+    if (started == 0) download->failed = 1;
+
+    int ramping = started < max_streams;
+    double best_rate = 0;
+    double since = now_seconds();
+    unsigned long long since_bytes = 0;
+    while (download->active > 0) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_nsec += RAMP_INTERVAL_MS * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&download->changed, &download->lock, &deadline);
+        if (!ramping || download->active == 0) continue;
+
+        double now = now_seconds();
+        if (now - since < RAMP_INTERVAL_MS / 1000.0) continue;
+        unsigned long long bytes = __atomic_load_n(&download->received, __ATOMIC_RELAXED);
+        double rate = (double)(bytes - since_bytes) / (now - since);
+        since = now;
+        since_bytes = bytes;
+
+        /* Stop adding streams once the last one did not pay off, or there is nothing left to share */
+        int work_left = download->next < download->size || download->retry_count > 0;
+        if (rate < best_rate * RAMP_GAIN || !work_left || download->failed ||
+            start_worker(download, threads, &started) < 0) {
+            ramping = 0;
+        } else {
+            best_rate = rate;
+            ramping = started < max_streams;
+        }
+    }
+    pthread_mutex_unlock(&download->lock);
+
+    for (size_t i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    free(threads);
+}
+
+/* Fetches the object in one request, for servers without ranges */
+static int download_whole(const char *url, HttpOutput *output) {
+    HttpRequestOptions options = {0};
+    options.sink = HTTP_SINK_OUTPUT;
+    options.output = output;
+
+    HttpResponse *response = http_request_ex("GET", url, NULL, &options);
+    int status = response ? response->status_code : 0;
+    http_response_free(response);
+    return status >= 200 && status < 300 ? 0 : -1;
+}
+
+int http_download(const char *url, HttpOutput *output, const HttpDownloadOptions *options, HttpDownloadStats *stats) {
+    if (!url || !output) return -1;
+    if (stats) memset(stats, 0, sizeof(*stats));
+
+    HttpDownloadOptions defaults = {0};
+    if (!options) options = &defaults;
+    size_t max_streams = options->max_streams ? options->max_streams : DEFAULT_STREAMS;
+    unsigned long long min_segment = options->min_segment ? options->min_segment : DEFAULT_MIN_SEGMENT;
+    unsigned long long max_segment = options->max_segment ? options->max_segment : DEFAULT_MAX_SEGMENT;
+    if (max_segment < min_segment) max_segment = min_segment;
+
+    /* The size and range support decide whether splitting is possible at all */
+    HttpResponse *head = http_head(url);
+    unsigned long long size = 0;
+    const HttpHeader *accept_ranges = http_response_header_id(head, HTTP_HEADER_ACCEPT_RANGES);
+    int segmentable = head && head->status_code == 200 &&
+                      header_number(http_response_header_id(head, HTTP_HEADER_CONTENT_LENGTH), &size) == 0 &&
+                      accept_ranges && accept_ranges->value_len == 5 && strncasecmp(accept_ranges->value, "bytes", 5) == 0;
+    http_response_free(head);
+
+    if (!segmentable || max_streams < 2 || size < 2 * min_segment) {
+        int status = download_whole(url, output);
+        if (stats) stats->peak_streams = 1;
+        return status;
+    }
+
+    if (http_output_reserve(output, size) < 0) return -1;
+
+    Download download;
+    memset(&download, 0, sizeof(download));
+    download.url = url;
+    download.output = output;
+    download.size = size;
+    download.min_segment = min_segment;
+    download.max_segment = max_segment;
+    /* Enough ranges for every stream to get several, before the rates are known */
+    download.first_segment = size / (max_streams * 4);
+    if (download.first_segment < min_segment) download.first_segment = min_segment;
+    if (download.first_segment > max_segment) download.first_segment = max_segment;
+    download.stats.size = size;
+    download.stats.segmented = 1;
+
+    pthread_mutex_init(&download.lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&download.changed, &attr);
+    pthread_condattr_destroy(&attr);
+
+    run_segmented(&download, max_streams);
+
+    int status = download.failed || download.received != size ? -1 : 0;
+    if (stats) *stats = download.stats;
+    pthread_cond_destroy(&download.changed);
+    pthread_mutex_destroy(&download.lock);
+    free(download.retry);
+    return status;
+}
+
+/* Returns the If-Range validator of a response: its strong ETag, or else its Last-Modified */
+static int response_validator(const HttpResponse *response, char *validator, size_t size) {
+    const HttpHeader *header = http_response_header_id(response, HTTP_HEADER_ETAG);
+    /* If-Range only takes strong entity tags */
+    if (!header || header->value_len < 2 || header->value[0] != '"') {
+        header = http_response_header_id(response, HTTP_HEADER_LAST_MODIFIED);
+    }
+    if (!header || header->value_len == 0 || header->value_len >= size) return -1;
+    memcpy(validator, header->value, header->value_len);
+    validator[header->value_len] = '\0';
+    return 0;
+}
+
+/* Returns the size of the whole object a 200, 206 or 416 response is about */
+static int response_total(const HttpResponse *response, unsigned long long *total) {
+    if (response->status_code == 200) {
+        return header_number(http_response_header_id(response, HTTP_HEADER_CONTENT_LENGTH), total);
+    }
+
+    /* The total follows the slash, in "bytes <first>-<last>/<total>" as in the unsatisfied form of a 416 */
+    const HttpHeader *header = http_response_header_id(response, HTTP_HEADER_CONTENT_RANGE);
+    if (!header) return -1;
+    const char *slash = memchr(header->value, '/', header->value_len);
+    if (!slash) return -1;
+    HttpHeader length = *header;
+    length.value = slash + 1;
+    length.value_len = header->value_len - (size_t)(slash + 1 - header->value);
+    return header_number(&length, total);
+}
+
+/* What a resumed request checks of its response */
+typedef struct {
+    unsigned long long offset;    // Where the range asked for starts
+    int wrong_range;              // A 206 held another range
+} ResumeCheck;
+
+/* Refuses a 206 holding another range than the one asked for, before any byte of it is written */
+static int check_resume(const HttpResponse *response, void *userdata) {
+    ResumeCheck *check = userdata;
+    check->wrong_range = response->status_code == 206 && !content_range_starts_at(response, check->offset);
+    return check->wrong_range ? -1 : 0;
+}
+
+static int read_validator(const char *file, char *validator, size_t size) {
+    FILE *fp = fopen(file, "r");
+    if (!fp) return -1;
+    int status = fgets(validator, (int)size, fp) ? 0 : -1;
+    fclose(fp);
+    if (status == 0) validator[strcspn(validator, "\r\n")] = '\0';
+    return status == 0 && validator[0] ? 0 : -1;
+}
+
+static int write_validator(const char *file, const char *validator) {
+    FILE *fp = fopen(file, "w");
+    if (!fp) return -1;
+    int status = fprintf(fp, "%s\n", validator) < 0 ? -1 : 0;
+    if (fclose(fp) != 0) status = -1;
+    return status;
+}
+
+int http_download_resume(const char *url, const char *path, HttpDownloadStats *stats) {
+    if (!url || !path) return -1;
+    HttpDownloadStats local;
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    stats->peak_streams = 1;
+
+    char *resume_file = malloc(strlen(path) + sizeof(RESUME_SUFFIX));
+    if (!resume_file) return -1;
+    strcpy(resume_file, path);
+    strcat(resume_file, RESUME_SUFFIX);
+
+    HttpOutput *output = http_output_open(path, HTTP_OUTPUT_KEEP);
+    if (!output) {
+        free(resume_file);
+        return -1;
+    }
+    stats->resumed_from = http_output_size(output);
+
+    char validator[MAX_VALIDATOR];
+    int have_validator = read_validator(resume_file, validator, sizeof(validator)) == 0;
+    if (!have_validator && stats->resumed_from == 0) {
+        HttpResponse *head = http_head(url);
+        if (head && head->status_code == 200 && response_validator(head, validator, sizeof(validator)) == 0) {
+            have_validator = write_validator(resume_file, validator) == 0;
+        }
+        http_response_free(head);
+    }
+
+    int status = -1;
+    int failures = 0;
+    while (failures < MAX_ATTEMPTS) {
+        unsigned long long size = http_output_size(output);
+        char range[64];
+        char if_range[MAX_VALIDATOR + 16];
+        const char *headers[2] = { NULL, NULL };
+
+        ResumeCheck check = { size, 0 };
+        HttpRequestOptions options = {0};
+        options.sink = HTTP_SINK_OUTPUT;
+        options.output = output;
+        options.output_offset = size;
+        options.on_headers = check_resume;
+        options.userdata = &check;
+        /* A compressed 200 would announce a length the decoded file never matches */
+        options.keep_encoding = 1;
+        if (size > 0) {
+            snprintf(range, sizeof(range), "bytes=%llu-", size);
+            options.range = range;
+            if (have_validator) {
+                snprintf(if_range, sizeof(if_range), "If-Range: %s", validator);
+                headers[0] = if_range;
+                options.headers = headers;
+            }
+        }
+
+        HttpResponse *response = http_request_ex("GET", url, NULL, &options);
+        int code = response ? response->status_code : 0;
+        unsigned long long total = 0;
+        int known_total = response && response_total(response, &total) == 0;
+
+        if (code == 416 && known_total && total == size) {
+            /* Everything was already there */
+            stats->size = total;
+            status = 0;
+        } else if (code == 200 || code == 206) {
+            /* Without a length, a body that ran to its end (chunked, or up to
+               the close) is the rest of the object */
+            if (!known_total && response->complete) {
+                total = http_output_size(output);
+                known_total = 1;
+            }
+            if (known_total) stats->size = total;
+            /* Keep the validator of what the file holds now for the next attempt */
+            char current[MAX_VALIDATOR];
+            if (response_validator(response, current, sizeof(current)) == 0) {
+                if (!have_validator || strcmp(current, validator) != 0) {
+                    strcpy(validator, current);
+                    have_validator = write_validator(resume_file, validator) == 0;
+                }
+            } else if (code == 200) {
+                have_validator = 0;
+                unlink(resume_file);
+            }
+            if (known_total && http_output_size(output) == total) status = 0;
+        } else if (check.wrong_range) {
+            /* The server cannot be trusted with this range: start over from the first byte */
+            if (http_output_truncate(output, 0) < 0) break;
+        } else if (code != 0) {
+            /* An error from the server is not worth retrying */
+            http_response_free(response);
+            break;
+        }
+        http_response_free(response);
+        if (status == 0) break;
+
+        stats->retries++;
+        failures = http_output_size(output) > size ? 0 : failures + 1;
+        if (failures < MAX_ATTEMPTS) sleep_ms(RETRY_DELAY_MS * failures);
+    }
+
+    if (http_output_close(output) < 0) status = -1;
+    if (status == 0) unlink(resume_file);
+    free(resume_file);
+    return status;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file http_encode.c
+ * @brief Implementation of the streaming request body compression in C.
+ *
+ * This file contains the implementation of the encoders that compress a
+ * request body while it is sent.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Each encoder wraps one zlib deflate or zstd compression stream. The body
+ * goes in as it is read or produced and the compressed bytes come out
+ * straight into the chunk being sent, so neither a copy of the body nor a
+ * compressed one is ever built. The libraries are optional at build time
+ * (HAVE_ZLIB, HAVE_ZSTD), like for the decoders.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_encode.h"
+#include <limits.h>
+#include <stdlib.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+struct HttpEncoder {
+    HttpCoding coding;
+#ifdef HAVE_ZLIB
+    z_stream zlib;
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_CCtx *zstd;
+#endif
+};
+
+const char* http_encode_name(HttpCoding coding) {
+    switch (coding) {
+#ifdef HAVE_ZLIB
+    case HTTP_CODING_GZIP:
+        return "gzip";
+    case HTTP_CODING_DEFLATE:
+        return "deflate";
+#endif
+#ifdef HAVE_ZSTD
+    case HTTP_CODING_ZSTD:
+        return "zstd";
+#endif
+    default:
+        return NULL;
+    }
+}
+
+#if defined(HAVE_ZLIB) || defined(HAVE_ZSTD)
+/* Brings a level within [1, max], 0 picking the default */
+static int clamp_level(int level, int fallback, int max) {
+    if (level == 0) return fallback;
+    if (level < 1) return 1;
+    return level > max ? max : level;
+}
+#endif
+
+HttpEncoder* http_encoder_new(HttpCoding coding, int level) {
+    HttpEncoder *encoder = calloc(1, sizeof(HttpEncoder));
+    if (!encoder) return NULL;
+    encoder->coding = coding;
+
+    switch (coding) {
+#ifdef HAVE_ZLIB
+    case HTTP_CODING_GZIP:
+    case HTTP_CODING_DEFLATE:
+        /* 16 added to the window bits writes the gzip wrapper */
+        if (deflateInit2(&encoder->zlib, clamp_level(level, Z_DEFAULT_COMPRESSION, 9), Z_DEFLATED,
+                         coding == HTTP_CODING_GZIP ? MAX_WBITS + 16 : MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+            return encoder;
+        }
+        break;
+#endif
+#ifdef HAVE_ZSTD
+    case HTTP_CODING_ZSTD:
+        encoder->zstd = ZSTD_createCCtx();
+        if (encoder->zstd &&
+            !ZSTD_isError(ZSTD_CCtx_setParameter(encoder->zstd, ZSTD_c_compressionLevel,
+                                                 clamp_level(level, ZSTD_CLEVEL_DEFAULT, 19)))) {
+            return encoder;
+        }
+        ZSTD_freeCCtx(encoder->zstd);
+        break;
+#endif
+    default:
+        (void)level;
+        break;
+    }
+    free(encoder);
+    return NULL;
+}
+
+#ifdef HAVE_ZLIB
+static int run_zlib(HttpEncoder *encoder, const char **in, size_t *in_len, int finish, char *out, size_t room, size_t *produced) {
+    z_stream *zlib = &encoder->zlib;
+    for (;;) {
+        uInt in_chunk = *in_len > UINT_MAX ? UINT_MAX : (uInt)*in_len;
+        uInt out_chunk = room - *produced > UINT_MAX ? UINT_MAX : (uInt)(room - *produced);
+        /* Only the call that sees the very last input byte may finish the stream */
+        int flush = finish && in_chunk == *in_len ? Z_FINISH : Z_NO_FLUSH;
+        zlib->next_in = (Bytef*)*in;
+        zlib->avail_in = in_chunk;
+        zlib->next_out = (Bytef*)out + *produced;
+        zlib->avail_out = out_chunk;
+        int status = deflate(zlib, flush);
+        size_t used = in_chunk - zlib->avail_in;
+        *in += used;
+        *in_len -= used;
+        *produced += out_chunk - zlib->avail_out;
+
+        if (status == Z_STREAM_END) return 1;
+        if (status != Z_OK && status != Z_BUF_ERROR) return -1;
+        if (*produced == room || (!*in_len && !finish)) return 0;
+    }
+}
+#endif
+
+#ifdef HAVE_ZSTD
+static int run_zstd(HttpEncoder *encoder, const char **in, size_t *in_len, int finish, char *out, size_t room, size_t *produced) {
+    ZSTD_inBuffer input = { *in, *in_len, 0 };
+    ZSTD_outBuffer output = { out, room, 0 };
+    size_t left;
+    do {
+        /* With ZSTD_e_end, what is left to flush; 0 once the frame is complete */
+        left = ZSTD_compressStream2(encoder->zstd, &output, &input, finish ? ZSTD_e_end : ZSTD_e_continue);
+        if (ZSTD_isError(left)) return -1;
+    } while (output.pos < output.size && (finish ? left != 0 : input.pos < input.size));
+    *in += input.pos;
+    *in_len -= input.pos;
+    *produced = output.pos;
+    return finish && left == 0;
+}
+#endif
+
+int http_encoder_run(HttpEncoder *encoder, const char **in, size_t *in_len, int finish, char *out, size_t *out_len) {
+    size_t room = *out_len;
+    *out_len = 0;
+
+    switch (encoder->coding) {
+#ifdef HAVE_ZLIB
+    case HTTP_CODING_GZIP:
+    case HTTP_CODING_DEFLATE:
+        return run_zlib(encoder, in, in_len, finish, out, room, out_len);
+#endif
+#ifdef HAVE_ZSTD
+    case HTTP_CODING_ZSTD:
+        return run_zstd(encoder, in, in_len, finish, out, room, out_len);
+#endif
+    default:
+        (void)in;
+        (void)in_len;
+        (void)finish;
+        (void)out;
+        (void)room;
+        return -1;
+    }
+}
+
+int http_encoder_reset(HttpEncoder *encoder) {
+    switch (encoder->coding) {
+#ifdef HAVE_ZLIB
+    case HTTP_CODING_GZIP:
+    case HTTP_CODING_DEFLATE:
+        return deflateReset(&encoder->zlib) == Z_OK ? 0 : -1;
+#endif
+#ifdef HAVE_ZSTD
+    case HTTP_CODING_ZSTD:
+        return ZSTD_isError(ZSTD_CCtx_reset(encoder->zstd, ZSTD_reset_session_only)) ? -1 : 0;
+#endif
+    default:
+        return -1;
+    }
+}
+
+void http_encoder_free(HttpEncoder *encoder) {
+    if (!encoder) return;
+#ifdef HAVE_ZLIB
+    if (encoder->coding == HTTP_CODING_GZIP || encoder->coding == HTTP_CODING_DEFLATE) deflateEnd(&encoder->zlib);
+#endif
+#ifdef HAVE_ZSTD
+    if (encoder->coding == HTTP_CODING_ZSTD) ZSTD_freeCCtx(encoder->zstd);
+#endif
+    free(encoder);
+}
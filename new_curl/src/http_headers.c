@@ -0,0 +1,149 @@
+/**
+ * @file http_headers.c
+ * @brief Implementation of the indexed response header table in C.
+ *
+ * This file contains the construction of the header table of an
+ * HttpResponse and the case-insensitive lookups into it.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Names are hashed with FNV-1a over their lower-cased bytes. The index has
+ * at least twice as many slots as there are headers and uses linear
+ * probing; each slot holds 1 + the position of a header, 0 meaning empty.
+ * Headers are inserted in the order received, so probing meets the first
+ * of several headers with the same name first.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_headers.h"
+#include <pthread.h>
+#include <string.h>
+#include <strings.h>
+
+#define MIN_INDEX_SIZE 16
+
+static const char *const well_known_names[HTTP_HEADER_WELL_KNOWN_COUNT] = {
+    [HTTP_HEADER_ACCEPT_RANGES] = "accept-ranges",
+    [HTTP_HEADER_AGE] = "age",
+    [HTTP_HEADER_CACHE_CONTROL] = "cache-control",
+    [HTTP_HEADER_CONNECTION] = "connection",
+    [HTTP_HEADER_CONTENT_ENCODING] = "content-encoding",
+    [HTTP_HEADER_CONTENT_LENGTH] = "content-length",
+    [HTTP_HEADER_CONTENT_RANGE] = "content-range",
+    [HTTP_HEADER_CONTENT_TYPE] = "content-type",
+    [HTTP_HEADER_DATE] = "date",
+    [HTTP_HEADER_ETAG] = "etag",
+    [HTTP_HEADER_EXPIRES] = "expires",
+    [HTTP_HEADER_LAST_MODIFIED] = "last-modified",
+    [HTTP_HEADER_LOCATION] = "location",
+    [HTTP_HEADER_RETRY_AFTER] = "retry-after",
+    [HTTP_HEADER_SERVER] = "server",
+    [HTTP_HEADER_SET_COOKIE] = "set-cookie",
+    [HTTP_HEADER_TRANSFER_ENCODING] = "transfer-encoding",
+    [HTTP_HEADER_VARY] = "vary",
+};
+
+static unsigned int well_known_hashes[HTTP_HEADER_WELL_KNOWN_COUNT];
+static pthread_once_t well_known_once = PTHREAD_ONCE_INIT;
+
+static void hash_well_known(void) {
+    for (int i = 0; i < HTTP_HEADER_WELL_KNOWN_COUNT; i++) {
+        well_known_hashes[i] = http_header_hash(well_known_names[i], strlen(well_known_names[i]));
+    }
+}
+
+unsigned int http_header_hash(const char *name, size_t len) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)name[i];
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+static size_t index_size_for(size_t count) {
+    size_t index_size = MIN_INDEX_SIZE;
+    while (index_size < count * 2) index_size *= 2;
+    return index_size;
+}
+
+size_t http_headers_size(size_t count) {
+    return count * sizeof(HttpHeader) + index_size_for(count) * sizeof(unsigned int);
+}
+
+HttpHeader* http_headers_place(HttpResponse *response, void *memory, size_t count) {
+    /* The index follows the array */
+    HttpHeader *fields = memory;
+    response->header_fields = fields;
+    response->header_count = count;
+    response->header_index = (unsigned int*)(fields + count);
+    response->header_index_size = index_size_for(count);
+    memset(response->header_index, 0, response->header_index_size * sizeof(unsigned int));
+    return fields;
+}
+
+void http_headers_index(HttpResponse *response) {
+    size_t mask = response->header_index_size - 1;
+    for (size_t i = 0; i < response->header_count; i++) {
+        HttpHeader *header = &response->header_fields[i];
+        header->hash = http_header_hash(header->name, header->name_len);
+
+        size_t slot = header->hash & mask;
+        while (response->header_index[slot]) slot = (slot + 1) & mask;
+        response->header_index[slot] = (unsigned int)i + 1;
+    }
+}
+
+static const HttpHeader* find_header(const HttpResponse *response, const char *name, size_t len, unsigned int hash) {
+    if (!response || !response->header_index) return NULL;
+
+    size_t mask = response->header_index_size - 1;
+    for (size_t slot = hash & mask; response->header_index[slot]; slot = (slot + 1) & mask) {
+        const HttpHeader *header = &response->header_fields[response->header_index[slot] - 1];
+        if (header->hash == hash && header->name_len == len && strncasecmp(header->name, name, len) == 0) {
+            return header;
+        }
+    }
+    return NULL;
+}
+
+const HttpHeader* http_response_header(const HttpResponse *response, const char *name) {
+    size_t len = strlen(name);
+    return find_header(response, name, len, http_header_hash(name, len));
+}
+
+const HttpHeader* http_response_header_id(const HttpResponse *response, HttpHeaderId id) {
+    if ((int)id < 0 || id >= HTTP_HEADER_WELL_KNOWN_COUNT) return NULL;
+    pthread_once(&well_known_once, hash_well_known);
+    const char *name = well_known_names[id];
+    return find_header(response, name, strlen(name), well_known_hashes[id]);
+}
+
+const HttpHeader* http_response_header_next(const HttpResponse *response, const HttpHeader *previous) {
+    if (!response || !previous) return NULL;
+
+    const HttpHeader *end = response->header_fields + response->header_count;
+    for (const HttpHeader *header = previous + 1; header < end; header++) {
+        if (header->hash == previous->hash && header->name_len == previous->name_len &&
+            strncasecmp(header->name, previous->name, previous->name_len) == 0) {
+            return header;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,705 @@
+/**
+ * @file http_multi.c
+ * @brief Implementation of concurrent http requests in C.
+ *
+ * This file contains the implementation of the multi interface, an epoll
+ * driven engine running many http requests on one thread.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Each transfer is a small state machine:
+ * QUEUED -> RESOLVING -> CONNECTING -> HANDSHAKE (https only) -> SENDING -> RECEIVING.
+ * A step runs until the socket would block, then the transfer registers for
+ * the readiness it waits on and yields. While resolving, that socket is the
+ * one of its DNS lookup, so lookups overlap each other and the transfers
+ * already running; transfers to a host being looked up wait for that lookup
+ * rather than sending their own queries. Idle connections come from and go
+ * back to the same pool as the blocking functions, so a batch of requests
+ * to one origin reuses its connections.
+ *
+ * With the io_uring transport, the plain http transfers epoll reports ready
+ * do not call send() and recv() each: their next send or receive goes into
+ * one batch, run by a single io_uring_enter(), and each takes in its result
+ * then waits for epoll again, the socket still being watched.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_multi.h"
+#include "http_dns.h"
+#include "http_internal.h"
+#include "http_pool.h"
+#include "http_reader.h"
+#include "http_tls.h"
+#include "http_uring.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <openssl/err.h>
+
+#define MULTI_DEFAULT_ACTIVE 64
+#define MULTI_MAX_EVENTS 64
+#define MAX_READ (1 << 30)
+
+typedef enum {
+    XFER_QUEUED,
+    XFER_RESOLVING,
+    XFER_CONNECTING,
+    XFER_HANDSHAKE,
+    XFER_SENDING,
+    XFER_RECEIVING
+} TransferState;
+
+typedef struct HttpTransfer {
+    HttpMulti *multi;
+    TransferState state;
+    HttpTarget target;
+    char *method;
+    char *request;                  // Header block followed by a copy of the body
+    size_t request_len;
+    size_t sent;                    // Request bytes written so far
+    HttpReader reader;              // Response being received
+    HttpConnection *conn;           // Connection in use (NULL while queued)
+    HttpDnsLookup *lookup;          // Host lookup under way (NULL when waiting for another transfer's)
+    HttpDnsAddresses addresses;     // Addresses of the host, tried in turn
+    size_t address;                 // Address being connected to
+    int sockfd;                     // Socket being connected before conn exists
+    SSL *ssl;                       // TLS session being negotiated before conn exists
+    unsigned int events;            // Events registered with epoll (0 if none)
+    int attempts;                   // Connections tried so far
+    HttpMultiCallback done;
+    void *userdata;
+    struct HttpTransfer *prev;
+    struct HttpTransfer *next;
+} HttpTransfer;
+
+struct HttpMulti {
+    int epfd;
+    size_t max_active;
+    size_t active_count;
+    HttpTransfer *active;           // Running transfers
+    HttpTransfer *queue_head;       // Transfers waiting for a free slot
+    HttpTransfer *queue_tail;
+    size_t queued_count;
+};
+
+static void transfer_step(HttpTransfer *t);
+static int transfer_open(HttpTransfer *t, const HttpDnsAddresses *addresses);
+static void lookup_done(HttpTransfer *t, const HttpDnsAddresses *addresses);
+
+static int set_nonblocking(int fd, int nonblocking) {
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0) return -1;
+    flags = nonblocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(fd, F_SETFL, flags);
+}
+
+static int transfer_fd(const HttpTransfer *t) {
+    if (t->lookup) return http_dns_lookup_fd(t->lookup, NULL);
+    return t->conn ? t->conn->sockfd : t->sockfd;
+}
+
+/* Registers the transfer's socket for events, or updates its registration */
+static int watch(HttpTransfer *t, unsigned int events) {
+    if (t->events == events) return 0;
+
+    struct epoll_event ev = { .events = events, .data.ptr = t };
+    int op = t->events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(t->multi->epfd, op, transfer_fd(t), &ev) < 0) {
+        perror("epoll_ctl failed");
+        return -1;
+    }
+    t->events = events;
+    return 0;
+}
+
+static void unwatch(HttpTransfer *t) {
+    if (!t->events) return;
+    epoll_ctl(t->multi->epfd, EPOLL_CTL_DEL, transfer_fd(t), NULL);
+    t->events = 0;
+}
+
+/* Maps an SSL_ERROR_WANT_* result onto the epoll events to wait for; -1 for real errors */
+static int watch_ssl(HttpTransfer *t, SSL *ssl, int ret) {
+    switch (SSL_get_error(ssl, ret)) {
+    case SSL_ERROR_WANT_READ:
+        return watch(t, EPOLLIN);
+    case SSL_ERROR_WANT_WRITE:
+        return watch(t, EPOLLOUT);
+    default:
+        return -1;
+    }
+}
+
+static void transfer_free(HttpTransfer *t) {
+    http_target_free(&t->target);
+    free(t->method);
+    free(t->request);
+    http_reader_free(&t->reader);
+    free(t);
+}
+
+static void active_unlink(HttpTransfer *t) {
+    HttpMulti *multi = t->multi;
+    if (t->prev) t->prev->next = t->next;
+    else multi->active = t->next;
+    if (t->next) t->next->prev = t->prev;
+    t->prev = t->next = NULL;
+    multi->active_count--;
+}
+
+/* Drops whatever connection the transfer holds */
+static void transfer_disconnect(HttpTransfer *t) {
+    unwatch(t);
+    if (t->lookup) {
+        /* The transfers waiting for this lookup would otherwise wait forever */
+        lookup_done(t, NULL);
+        http_dns_lookup_free(t->lookup);
+        t->lookup = NULL;
+    }
+    if (t->conn) {
+        http_connection_close(t->conn);
+        t->conn = NULL;
+    }
+    if (t->ssl) {
+        SSL_free(t->ssl);
+        t->ssl = NULL;
+    }
+    if (t->sockfd >= 0) {
+        close(t->sockfd);
+        t->sockfd = -1;
+    }
+}
+
+/* Ends a transfer: hands the connection back to the pool if reusable and reports the response */
+static void transfer_finish(HttpTransfer *t, int ok) {
+    HttpResponse *response = NULL;
+
+    if (ok) {
+        if (t->reader.complete && t->reader.keep_alive) {
+            unwatch(t);
+            if (set_nonblocking(t->conn->sockfd, 0) == 0) {
+                http_pool_release(t->conn);
+                t->conn = NULL;
+            }
+        }
+        response = parse_http_response(&t->reader);
+    }
+    transfer_disconnect(t);
+
+    active_unlink(t);
+    if (t->done) t->done(response, t->userdata);
+    else http_response_free(response);
+    transfer_free(t);
+}
+
+/* Opens a non-blocking connection, reusing an idle pooled one if possible */
+static int transfer_connect(HttpTransfer *t) {
+    t->attempts++;
+    t->sent = 0;
+    http_reader_free(&t->reader);
+    if (http_reader_init(&t->reader, t->method) < 0) return -1;
+    if (http_accepts_encoding(t->method, NULL)) http_reader_decode(&t->reader, 0);
+
+    /* Only the first attempt may use the pool; a retry always connects afresh */
+    if (t->attempts == 1) {
+        t->conn = http_pool_acquire(t->target.scheme, t->target.host, t->target.port);
+        if (t->conn) {
+            if (set_nonblocking(t->conn->sockfd, 1) < 0) {
+                http_connection_close(t->conn);
+                t->conn = NULL;
+            } else {
+                t->state = XFER_SENDING;
+                return 0;
+            }
+        }
+    }
+
+    /* Another transfer looking the host up answers for this one too */
+    t->state = XFER_RESOLVING;
+    for (HttpTransfer *other = t->multi->active; other; other = other->next) {
+        if (other->lookup && strcmp(other->target.host, t->target.host) == 0) return 0;
+    }
+
+    HttpDnsAddresses addresses;
+    if (http_dns_lookup_start(t->target.host, &addresses, &t->lookup) < 0) {
+        fprintf(stderr, "Could not resolve host: %s\n", t->target.host);
+        return -1;
+    }
+    return t->lookup ? 0 : transfer_open(t, &addresses);
+}
+
+/* Starts connecting to the current address of the host, or the next ones that do not fail right away */
+static int connect_address(HttpTransfer *t) {
+    for (; t->address < t->addresses.count; t->address++) {
+        struct sockaddr_in server_addr = {
+            .sin_family = AF_INET,
+            .sin_port = htons(t->target.port),
+            .sin_addr = t->addresses.addresses[t->address]
+        };
+
+        t->sockfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (t->sockfd < 0) {
+            perror("Socket creation failed");
+            return -1;
+        }
+        if (connect(t->sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr)) == 0 || errno == EINPROGRESS) {
+            t->state = XFER_CONNECTING;
+            return 0;
+        }
+        close(t->sockfd);
+        t->sockfd = -1;
+    }
+    perror("Connection failed");
+    return -1;
+}
+
+/* Starts connecting to the addresses of the host, in turn */
+static int transfer_open(HttpTransfer *t, const HttpDnsAddresses *addresses) {
+    t->addresses = *addresses;
+    t->address = 0;
+    return connect_address(t);
+}
+
+/*
+ * Handles a failure on the transfer's connection. A pooled connection the
+ * server closed while idle gets one retry on a fresh connection.
+ */
+static void transfer_fail(HttpTransfer *t) {
+    int retry = t->conn && t->conn->reused && t->reader.len == 0;
+    transfer_disconnect(t);
+    if (retry && transfer_connect(t) == 0) {
+        transfer_step(t);
+        return;
+    }
+    transfer_finish(t, 0);
+}
+
+/*
+ * Hands the outcome of a lookup to the transfers that waited for it: they
+ * connect, or fail like the transfer that looked the host up.
+ */
+static void lookup_done(HttpTransfer *t, const HttpDnsAddresses *addresses) {
+    HttpMulti *multi = t->multi;
+    for (;;) {
+        HttpTransfer *waiting = multi->active;
+        while (waiting && (waiting == t || waiting->state != XFER_RESOLVING || waiting->lookup ||
+                           strcmp(waiting->target.host, t->target.host) != 0)) {
+            waiting = waiting->next;
+        }
+        if (!waiting) return;
+
+        /* Starting it may end it, and others: search again from the start */
+        if (!addresses || transfer_open(waiting, addresses) < 0) {
+            transfer_fail(waiting);
+        } else {
+            transfer_step(waiting);
+        }
+    }
+}
+
+static int step_resolving(HttpTransfer *t) {
+    /* Waits for the transfer looking the same host up */
+    if (!t->lookup) return 0;
+
+    /* The lookup may move to another socket, even one reusing the same number */
+    unwatch(t);
+    HttpDnsAddresses addresses;
+    int found = http_dns_lookup_process(t->lookup, &addresses);
+    if (found == 0) {
+        int want_write;
+        http_dns_lookup_fd(t->lookup, &want_write);
+        return watch(t, want_write ? EPOLLOUT : EPOLLIN);
+    }
+
+    http_dns_lookup_free(t->lookup);
+    t->lookup = NULL;
+    lookup_done(t, found > 0 ? &addresses : NULL);
+    if (found < 0) {
+        fprintf(stderr, "Could not resolve host: %s\n", t->target.host);
+        return -1;
+    }
+    return transfer_open(t, &addresses) < 0 ? -1 : 1;
+}
+
+static int step_connecting(HttpTransfer *t) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(t->sockfd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err) {
+        if (err == EINPROGRESS || err == EALREADY) return watch(t, EPOLLOUT);
+        if (t->address + 1 < t->addresses.count) {
+            /* Like connect_to_host(), move on to the next address of the host */
+            unwatch(t);
+            close(t->sockfd);
+            t->sockfd = -1;
+            t->address++;
+            return connect_address(t) < 0 ? -1 : 1;
+        }
+        fprintf(stderr, "Connection failed: %s\n", strerror(err ? err : errno));
+        return -1;
+    }
+    if (!t->events) {
+        /* connect() has not been polled yet; wait for it to complete */
+        return watch(t, EPOLLOUT);
+    }
+
+    if (t->target.use_ssl) {
+        t->ssl = http_tls_new(t->sockfd, t->target.host, t->target.port);
+        if (!t->ssl) return -1;
+        t->state = XFER_HANDSHAKE;
+        return 1;
+    }
+
+    t->conn = http_connection_new(t->sockfd, NULL, t->target.scheme, t->target.host, t->target.port);
+    if (!t->conn) return -1;
+    t->sockfd = -1;
+    t->state = XFER_SENDING;
+    /* The socket is watched for writing already: with io_uring the request goes in the next batch */
+    return http_use_uring() ? 0 : 1;
+}
+
+static int step_handshake(HttpTransfer *t) {
+    int ret = SSL_connect(t->ssl);
+    if (ret <= 0) {
+        if (watch_ssl(t, t->ssl, ret) == 0) return 0;
+        fprintf(stderr, "SSL connection failed\n");
+        ERR_print_errors_fp(stderr);
+        return -1;
+    }
+    http_tls_handshake_done(t->ssl);
+
+    t->conn = http_connection_new(t->sockfd, t->ssl, t->target.scheme, t->target.host, t->target.port);
+    if (!t->conn) return -1;
+    t->sockfd = -1;
+    t->ssl = NULL;
+    t->state = XFER_SENDING;
+    return 1;
+}
+
+static int step_sending(HttpTransfer *t) {
+    while (t->sent < t->request_len) {
+        const char *data = t->request + t->sent;
+        size_t len = t->request_len - t->sent;
+        if (t->conn->ssl) {
+            int n = SSL_write(t->conn->ssl, data, (int)len);
+            if (n <= 0) return watch_ssl(t, t->conn->ssl, n);
+            t->sent += (size_t)n;
+        } else {
+            ssize_t n = send(t->conn->sockfd, data, len, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return watch(t, EPOLLOUT);
+                return -1;
+            }
+            t->sent += (size_t)n;
+        }
+    }
+    t->state = XFER_RECEIVING;
+    return 1;
+}
+
+/* Returns 2 once the response is complete or the server closed the connection */
+static int step_receiving(HttpTransfer *t) {
+    for (;;) {
+        size_t avail;
+        char *buf = http_reader_buffer(&t->reader, &avail);
+        if (!buf) return -1;
+        if (avail > MAX_READ) avail = MAX_READ;
+
+        size_t n;
+        if (t->conn->ssl) {
+            int ret = SSL_read(t->conn->ssl, buf, (int)avail);
+            if (ret <= 0) {
+                int err = SSL_get_error(t->conn->ssl, ret);
+                if (err != SSL_ERROR_ZERO_RETURN && watch_ssl(t, t->conn->ssl, ret) == 0) return 0;
+                http_reader_close(&t->reader);
+                return t->reader.len ? 2 : -1;
+            }
+            n = (size_t)ret;
+        } else {
+            ssize_t ret = recv(t->conn->sockfd, buf, avail, 0);
+            if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return watch(t, EPOLLIN);
+            if (ret <= 0) {
+                http_reader_close(&t->reader);
+                return t->reader.len ? 2 : -1;
+            }
+            n = (size_t)ret;
+        }
+
+        int status = http_reader_commit(&t->reader, n);
+        if (status < 0) return -1;
+        if (status > 0) return 2;
+    }
+}
+
+/* Runs the transfer's state machine until it has to wait or is finished */
+static void transfer_step(HttpTransfer *t) {
+    for (;;) {
+        int ret;
+        switch (t->state) {
+        case XFER_RESOLVING:
+            ret = step_resolving(t);
+            break;
+        case XFER_CONNECTING:
+            ret = step_connecting(t);
+            break;
+        case XFER_HANDSHAKE:
+            ret = step_handshake(t);
+            break;
+        case XFER_SENDING:
+            ret = step_sending(t);
+            break;
+        case XFER_RECEIVING:
+            ret = step_receiving(t);
+            break;
+        default:
+            ret = -1;
+            break;
+        }
+
+        if (ret < 0) {
+            transfer_fail(t);
+            return;
+        }
+        if (ret == 2) {
+            transfer_finish(t, 1);
+            return;
+        }
+        if (ret == 0) return;
+    }
+}
+
+/* Describes the send or receive a ready plain http transfer does next; 0 if it steps as usual */
+static int batch_op(HttpTransfer *t, HttpUringOp *op) {
+    if (!t->conn || t->conn->ssl) return 0;
+    if (t->state == XFER_SENDING && t->sent < t->request_len) {
+        op->send = 1;
+        op->buf = t->request + t->sent;
+        op->len = t->request_len - t->sent;
+    } else if (t->state == XFER_RECEIVING) {
+        size_t avail;
+        char *buf = http_reader_buffer(&t->reader, &avail);
+        if (!buf) return 0;
+        op->send = 0;
+        op->buf = buf;
+        op->len = avail > MAX_READ ? MAX_READ : avail;
+    } else {
+        return 0;
+    }
+    op->sockfd = t->conn->sockfd;
+    return 1;
+}
+
+/* Takes in the result of a batched send or receive, like step_sending() and step_receiving() */
+static int batch_done(HttpTransfer *t, const HttpUringOp *op) {
+    if (op->result == -EAGAIN || op->result == -EWOULDBLOCK || op->result == -EINTR) return 0;
+    if (op->send) {
+        if (op->result < 0) return -1;
+        t->sent += (size_t)op->result;
+        if (t->sent < t->request_len) return 0;
+        t->state = XFER_RECEIVING;
+        return watch(t, EPOLLIN);
+    }
+    if (op->result <= 0) {
+        http_reader_close(&t->reader);
+        return t->reader.len ? 2 : -1;
+    }
+    int status = http_reader_commit(&t->reader, (size_t)op->result);
+    return status < 0 ? -1 : status > 0 ? 2 : 0;
+}
+
+/*
+ * Steps the transfers epoll reported ready. With io_uring, the sends and
+ * receives of the plain http ones go to the kernel in one batch first.
+ */
+static void step_ready(struct epoll_event *events, int n) {
+    HttpUringOp ops[MULTI_MAX_EVENTS];
+    HttpTransfer *batched[MULTI_MAX_EVENTS];
+    size_t count = 0;
+    if (http_use_uring()) {
+        for (int i = 0; i < n; i++) {
+            HttpTransfer *t = events[i].data.ptr;
+            if (!batch_op(t, &ops[count])) continue;
+            batched[count++] = t;
+            events[i].data.ptr = NULL;
+        }
+    }
+
+    if (count > 0 && http_uring_batch(ops, count) < 0) {
+        /* Nothing was submitted: they step on their own */
+        for (size_t i = 0; i < count; i++) transfer_step(batched[i]);
+        count = 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        int ret = batch_done(batched[i], &ops[i]);
+        if (ret < 0) {
+            transfer_fail(batched[i]);
+        } else if (ret == 2) {
+            transfer_finish(batched[i], 1);
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.ptr) transfer_step(events[i].data.ptr);
+    }
+}
+
+/* Moves queued transfers into free slots and starts them */
+static void start_queued(HttpMulti *multi) {
+    while (multi->queue_head && multi->active_count < multi->max_active) {
+        HttpTransfer *t = multi->queue_head;
+        multi->queue_head = t->next;
+        if (!multi->queue_head) multi->queue_tail = NULL;
+        multi->queued_count--;
+
+        t->next = multi->active;
+        t->prev = NULL;
+        if (multi->active) multi->active->prev = t;
+        multi->active = t;
+        multi->active_count++;
+
+        if (transfer_connect(t) < 0) {
+            transfer_fail(t);
+        } else {
+            transfer_step(t);
+        }
+    }
+}
+
+/* Runs the lookups whose answer is late, so they ask again or another server */
+static void expire_lookups(HttpMulti *multi) {
+    for (;;) {
+        HttpTransfer *t = multi->active;
+        while (t && (!t->lookup || http_dns_lookup_timeout(t->lookup) > 0)) t = t->next;
+        if (!t) return;
+
+        /* Stepping it may end other transfers: search again from the start */
+        transfer_step(t);
+    }
+}
+
+HttpMulti* http_multi_create(size_t max_active) {
+    HttpMulti *multi = calloc(1, sizeof(HttpMulti));
+    if (!multi) return NULL;
+
+    multi->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (multi->epfd < 0) {
+        perror("epoll_create1 failed");
+        free(multi);
+        return NULL;
+    }
+    multi->max_active = max_active ? max_active : MULTI_DEFAULT_ACTIVE;
+    return multi;
+}
+
+int http_multi_add(HttpMulti *multi, const char *method, const char *url, const char *body,
+                   HttpMultiCallback done, void *userdata) {
+    if (!multi || !method || !url) return -1;
+
+    HttpTransfer *t = calloc(1, sizeof(HttpTransfer));
+    if (!t) return -1;
+
+    t->multi = multi;
+    t->sockfd = -1;
+    t->done = done;
+    t->userdata = userdata;
+    t->method = strdup(method);
+    if (!t->method ||
+        http_target_parse(url, strncmp(url, "https://", 8) == 0, &t->target) < 0) {
+        transfer_free(t);
+        return -1;
+    }
+    /* The body is copied after the header block, sized to fit both */
+    size_t body_len = body ? strlen(body) : 0;
+    size_t head_len = http_format_head(NULL, 0, &t->target, method, body_len, NULL);
+    t->request = malloc(head_len + body_len + 1);
+    if (!t->request) {
+        transfer_free(t);
+        return -1;
+    }
+    http_format_head(t->request, head_len + 1, &t->target, method, body_len, NULL);
+    if (body_len) memcpy(t->request + head_len, body, body_len);
+    t->request_len = head_len + body_len;
+
+    if (multi->queue_tail) multi->queue_tail->next = t;
+    else multi->queue_head = t;
+    multi->queue_tail = t;
+    multi->queued_count++;
+    return 0;
+}
+
+int http_multi_poll(HttpMulti *multi, int timeout_ms) {
+    if (!multi) return -1;
+
+    start_queued(multi);
+    if (multi->active_count == 0) return (int)multi->queued_count;
+
+    /* A lookup whose answer is late cannot wait for its socket */
+    int wait_ms = http_multi_timeout(multi);
+    if (wait_ms >= 0 && (timeout_ms < 0 || wait_ms < timeout_ms)) timeout_ms = wait_ms;
+
+    struct epoll_event events[MULTI_MAX_EVENTS];
+    int n = epoll_wait(multi->epfd, events, MULTI_MAX_EVENTS, timeout_ms);
+    if (n < 0 && errno != EINTR) {
+        perror("epoll_wait failed");
+        return -1;
+    }
+    step_ready(events, n);
+    expire_lookups(multi);
+
+    start_queued(multi);
+    return (int)(multi->active_count + multi->queued_count);
+}
+
+int http_multi_perform(HttpMulti *multi) {
+    return http_multi_poll(multi, 0);
+}
+
+int http_multi_fd(const HttpMulti *multi) {
+    return multi->epfd;
+}
+
+int http_multi_timeout(const HttpMulti *multi) {
+    int timeout_ms = -1;
+    for (const HttpTransfer *t = multi->active; t; t = t->next) {
+        if (!t->lookup) continue;
+        int due = http_dns_lookup_timeout(t->lookup);
+        if (timeout_ms < 0 || due < timeout_ms) timeout_ms = due;
+    }
+    return timeout_ms;
+}
+
+void http_multi_destroy(HttpMulti *multi) {
+    if (!multi) return;
+
+    while (multi->active) {
+        transfer_finish(multi->active, 0);
+    }
+    while (multi->queue_head) {
+        HttpTransfer *t = multi->queue_head;
+        multi->queue_head = t->next;
+        if (t->done) t->done(NULL, t->userdata);
+        transfer_free(t);
+    }
+    close(multi->epfd);
+    free(multi);
+}
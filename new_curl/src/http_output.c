@@ -0,0 +1,164 @@
+/**
+ * @file http_output.c
+ * @brief Implementation of the download output files in C.
+ *
+ * This file contains the implementation of the output files response bodies
+ * are written to, reserved with fallocate() and optionally memory-mapped.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Writes go to the mapping when the file is mapped and the bytes fall
+ * inside it, and through pwrite() otherwise. Only a file whose blocks
+ * fallocate() reserved is mapped. The furthest offset written is
+ * tracked with an atomic maximum, so that a transfer that stopped early
+ * leaves a file ending where its data ends rather than a reserved tail of
+ * zeros.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#define _GNU_SOURCE
+#include "http_output.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct HttpOutput {
+    int fd;
+    int flags;
+    pthread_mutex_t lock;           // Guards reserving and mapping
+    unsigned long long reserved;    // Bytes reserved with fallocate() (or ftruncate())
+    char *map;                      // Shared mapping of the reserved bytes, or NULL
+    size_t map_len;
+    unsigned long long end;         // End of the furthest write
+};
+
+HttpOutput* http_output_open(const char *path, int flags) {
+    /* A shared writable mapping needs the file open for reading too */
+    if (flags & HTTP_OUTPUT_KEEP) flags &= ~HTTP_OUTPUT_MMAP;
+    int fd = open(path, O_CREAT | O_CLOEXEC | ((flags & HTTP_OUTPUT_KEEP) ? 0 : O_TRUNC) |
+                        ((flags & HTTP_OUTPUT_MMAP) ? O_RDWR : O_WRONLY), 0644);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    HttpOutput *output = calloc(1, sizeof(HttpOutput));
+    if (!output) {
+        close(fd);
+        return NULL;
+    }
+    output->fd = fd;
+    output->flags = flags;
+    output->end = (unsigned long long)st.st_size;
+    pthread_mutex_init(&output->lock, NULL);
+    return output;
+}
+
+int http_output_reserve(HttpOutput *output, unsigned long long size) {
+    int status = 0;
+    pthread_mutex_lock(&output->lock);
+    if (size > output->reserved && !output->map) {
+        /* Filesystems without fallocate() still get the size, as a sparse file; a
+           kept file gets its blocks but keeps ending at its last byte */
+        int keep = (output->flags & HTTP_OUTPUT_KEEP) != 0;
+        int allocated = fallocate(output->fd, keep ? FALLOC_FL_KEEP_SIZE : 0, 0, (off_t)size) == 0;
+        if (!allocated) {
+            if (errno != EOPNOTSUPP && errno != ENOSYS) status = -1;
+            else if (!keep && ftruncate(output->fd, (off_t)size) < 0) status = -1;
+        }
+        if (status == 0) output->reserved = size;
+
+        /* A sparse file is written with pwrite(): a full disk then fails the write,
+           where storing into a mapped hole would raise SIGBUS */
+        if (allocated && (output->flags & HTTP_OUTPUT_MMAP) && size <= SIZE_MAX) {
+            void *map = mmap(NULL, (size_t)size, PROT_WRITE, MAP_SHARED, output->fd, 0);
+            if (map != MAP_FAILED) {
+                output->map = map;
+                output->map_len = (size_t)size;
+            }
+        }
+    }
+    pthread_mutex_unlock(&output->lock);
+    return status;
+}
+
+int http_output_write_at(HttpOutput *output, unsigned long long offset, const char *data, size_t len) {
+    /* The mapping only changes under the lock, before any write lands in it */
+    pthread_mutex_lock(&output->lock);
+    char *map = output->map;
+    size_t map_len = output->map_len;
+    pthread_mutex_unlock(&output->lock);
+
+    if (map && offset <= map_len && len <= map_len - offset) {
+        memcpy(map + offset, data, len);
+    } else {
+        for (size_t done = 0; done < len;) {
+            ssize_t n = pwrite(output->fd, data + done, len - done, (off_t)(offset + done));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return -1;
+            done += (size_t)n;
+        }
+    }
+
+    unsigned long long end = offset + len;
+    unsigned long long seen = __atomic_load_n(&output->end, __ATOMIC_RELAXED);
+    while (end > seen && !__atomic_compare_exchange_n(&output->end, &seen, end, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return 0;
+}
+
+unsigned long long http_output_size(const HttpOutput *output) {
+    return __atomic_load_n(&output->end, __ATOMIC_RELAXED);
+}
+
+int http_output_truncate(HttpOutput *output, unsigned long long size) {
+    int status = 0;
+    pthread_mutex_lock(&output->lock);
+    if (output->map && munmap(output->map, output->map_len) < 0) status = -1;
+    output->map = NULL;
+    output->map_len = 0;
+    if (ftruncate(output->fd, (off_t)size) < 0) status = -1;
+    output->reserved = 0;
+    __atomic_store_n(&output->end, size, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&output->lock);
+    return status;
+}
+
+int http_output_fd(const HttpOutput *output) {
+    return output->fd;
+}
+
+int http_output_close(HttpOutput *output) {
+    if (!output) return 0;
+
+    int status = 0;
+    if (output->map && munmap(output->map, output->map_len) < 0) status = -1;
+    if (output->end < output->reserved && ftruncate(output->fd, (off_t)output->end) < 0) status = -1;
+    if (close(output->fd) < 0) status = -1;
+    pthread_mutex_destroy(&output->lock);
+    free(output);
+    return status;
+}
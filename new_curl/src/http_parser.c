@@ -0,0 +1,595 @@
+/**
+ * @file http_parser.c
+ * @brief Implementation of the incremental HTTP/1.1 response parser in C.
+ *
+ * This file contains the implementation of a push-based, resumable parser
+ * for HTTP/1.1 responses.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * The parser is a state machine that walks each byte once. Everything it
+ * needs from the headers (Content-Length, Transfer-Encoding, Connection) is
+ * worked out while the bytes go by: header names are matched against the
+ * known ones letter by letter, the length is accumulated digit by digit and
+ * the value tokens are matched the same way as names. Header names end at
+ * the colon the vectorized scanner finds, their bytes checked and matched
+ * in a tight loop behind it; the values of the other headers and the
+ * reason phrase are skipped with the same scanner, and bodies in bulk:
+ * only the chunk framing is looked at byte by byte, its sizes through a hex
+ * digit table.
+ *
+ * Chunked bodies are reported without their framing, one call per run of
+ * chunk data, so a caller keeping the body can pack the runs together in
+ * place. Trailer fields go through the header states again, without
+ * affecting the framing, and are reported apart from the headers.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_parser.h"
+#include "http_scan.h"
+#include <limits.h>
+#include <string.h>
+
+#define MAX_HEADER_BYTES (256 * 1024)
+
+enum {
+    S_START,
+    S_PROTOCOL,
+    S_MAJOR,
+    S_MINOR,
+    S_STATUS_CODE,
+    S_REASON,
+    S_STATUS_LF,
+    S_HEADER_START,
+    S_HEADER_NAME,
+    S_VALUE_START,
+    S_VALUE,
+    S_HEADER_LF,
+    S_HEADERS_LF,
+    S_BODY_IDENTITY,
+    S_BODY_CLOSE,
+    S_CHUNK_SIZE,
+    S_CHUNK_EXT,
+    S_CHUNK_SIZE_LF,
+    S_CHUNK_DATA,
+    S_CHUNK_DATA_CR,
+    S_CHUNK_DATA_LF,
+    S_DONE,
+    S_ERROR
+};
+
+/* Headers that decide the framing of the message; lower case */
+enum { HEADER_OTHER, HEADER_CONTENT_LENGTH, HEADER_TRANSFER_ENCODING, HEADER_CONNECTION };
+static const char *const known_headers[] = { "content-length", "transfer-encoding", "connection" };
+
+/* Value tokens of those headers; lower case */
+enum { TOKEN_OTHER, TOKEN_CHUNKED, TOKEN_CLOSE, TOKEN_KEEP_ALIVE };
+static const char *const known_tokens[] = { "chunked", "close", "keep-alive" };
+
+#define KNOWN_MASK 0x7u
+
+static int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/* Hex digit values plus one; 0 for bytes that are not hex digits */
+static const unsigned char hex_digits[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+};
+
+/* Control characters, HT excepted */
+static int is_ctl(char c) {
+    return ((unsigned char)c < 0x20 && c != '\t') || c == 0x7f;
+}
+
+/* Bytes allowed in header names (RFC 9110 tchar) */
+static const unsigned char token_chars[256] = {
+    ['!'] = 1, ['#'] = 1, ['$'] = 1, ['%'] = 1, ['&'] = 1, ['\''] = 1, ['*'] = 1, ['+'] = 1,
+    ['-'] = 1, ['.'] = 1, ['^'] = 1, ['_'] = 1, ['`'] = 1, ['|'] = 1, ['~'] = 1,
+    ['0'] = 1, ['1'] = 1, ['2'] = 1, ['3'] = 1, ['4'] = 1, ['5'] = 1, ['6'] = 1, ['7'] = 1, ['8'] = 1, ['9'] = 1,
+    ['A'] = 1, ['B'] = 1, ['C'] = 1, ['D'] = 1, ['E'] = 1, ['F'] = 1, ['G'] = 1, ['H'] = 1, ['I'] = 1,
+    ['J'] = 1, ['K'] = 1, ['L'] = 1, ['M'] = 1, ['N'] = 1, ['O'] = 1, ['P'] = 1, ['Q'] = 1, ['R'] = 1,
+    ['S'] = 1, ['T'] = 1, ['U'] = 1, ['V'] = 1, ['W'] = 1, ['X'] = 1, ['Y'] = 1, ['Z'] = 1,
+    ['a'] = 1, ['b'] = 1, ['c'] = 1, ['d'] = 1, ['e'] = 1, ['f'] = 1, ['g'] = 1, ['h'] = 1, ['i'] = 1,
+    ['j'] = 1, ['k'] = 1, ['l'] = 1, ['m'] = 1, ['n'] = 1, ['o'] = 1, ['p'] = 1, ['q'] = 1, ['r'] = 1,
+    ['s'] = 1, ['t'] = 1, ['u'] = 1, ['v'] = 1, ['w'] = 1, ['x'] = 1, ['y'] = 1, ['z'] = 1,
+};
+
+static int is_token_char(char c) {
+    return token_chars[(unsigned char)c];
+}
+
+/* Drops the words of mask whose letter at pos is not c (case-insensitive) */
+static unsigned int match_step(unsigned int mask, const char *const *words, size_t pos, char c) {
+    char lower = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    for (unsigned int i = 0; mask >> i; i++) {
+        if ((mask & (1u << i)) && words[i][pos] != lower) mask &= ~(1u << i);
+    }
+    return mask;
+}
+
+/* Returns 1 + the index of the word of mask that is exactly len letters long, or 0 */
+static int match_word(unsigned int mask, const char *const *words, size_t len) {
+    for (unsigned int i = 0; mask >> i; i++) {
+        if ((mask & (1u << i)) && strlen(words[i]) == len) return i + 1;
+    }
+    return 0;
+}
+
+/* Interim responses (1xx but 101) are followed by the real one */
+static int is_interim(const HttpParser *parser) {
+    return parser->status_code >= 100 && parser->status_code < 200 && parser->status_code != 101;
+}
+
+static int has_no_body(const HttpParser *parser) {
+    return parser->head_request || (parser->status_code >= 100 && parser->status_code < 200) ||
+           parser->status_code == 204 || parser->status_code == 304;
+}
+
+/* Bodies reported as they are on the wire, without framing to strip */
+static int raw_body(int state) {
+    return state == S_BODY_IDENTITY || state == S_BODY_CLOSE;
+}
+
+static void reset_message(HttpParser *parser) {
+    parser->status_code = 0;
+    parser->content_length = -1;
+    parser->remaining = 0;
+    parser->chunked = 0;
+    parser->trailers = 0;
+    parser->connection_close = 0;
+    parser->connection_keep_alive = 0;
+    parser->digits = 0;
+}
+
+static HttpParserError status_line_done(HttpParser *parser) {
+    parser->state = S_HEADER_START;
+    if (is_interim(parser) || !parser->callbacks->on_status) return HTTP_PARSER_OK;
+    return parser->callbacks->on_status(parser, parser->mark, parser->value_end - parser->mark)
+           ? HTTP_PARSER_ERROR_CALLBACK : HTTP_PARSER_OK;
+}
+
+/* Ends a token of a Transfer-Encoding or Connection value */
+static void token_done(HttpParser *parser) {
+    if (parser->token_len == 0) return;
+
+    int token = match_word(parser->token_match, known_tokens, parser->token_len);
+    if (parser->header_kind == HEADER_TRANSFER_ENCODING) {
+        /* Only the last coding tells whether the body is chunked */
+        parser->chunked = token == TOKEN_CHUNKED;
+    } else if (token == TOKEN_CLOSE) {
+        parser->connection_close = 1;
+    } else if (token == TOKEN_KEEP_ALIVE) {
+        parser->connection_keep_alive = 1;
+    }
+    parser->token_len = 0;
+    parser->token_match = KNOWN_MASK;
+}
+
+/* Works out the framing from one byte of a header value */
+static HttpParserError value_byte(HttpParser *parser, char c, size_t offset) {
+    switch (parser->header_kind) {
+    case HEADER_CONTENT_LENGTH:
+        if (is_digit(c)) {
+            /* Digits must be contiguous: the previous byte was not blank */
+            if (parser->digits && parser->value_end != offset) return HTTP_PARSER_ERROR_CONTENT_LENGTH;
+            if (parser->remaining > (unsigned long long)(LLONG_MAX - (c - '0')) / 10) return HTTP_PARSER_ERROR_CONTENT_LENGTH;
+            parser->remaining = parser->remaining * 10 + (c - '0');
+            parser->digits++;
+        } else if (c != ' ' && c != '\t') {
+            return HTTP_PARSER_ERROR_CONTENT_LENGTH;
+        }
+        break;
+    case HEADER_TRANSFER_ENCODING:
+    case HEADER_CONNECTION:
+        if (c == ',') {
+            token_done(parser);
+            parser->token_params = 0;
+        } else if (parser->token_params) {
+            break;
+        } else if (c == ' ' || c == '\t' || c == ';') {
+            token_done(parser);
+            parser->token_params = c == ';';
+        } else {
+            parser->token_match = match_step(parser->token_match, known_tokens, parser->token_len, c);
+            parser->token_len++;
+        }
+        break;
+    }
+    return HTTP_PARSER_OK;
+}
+
+static HttpParserError header_done(HttpParser *parser) {
+    if (parser->header_kind == HEADER_CONTENT_LENGTH) {
+        if (!parser->digits) return HTTP_PARSER_ERROR_CONTENT_LENGTH;
+        if (parser->content_length >= 0 && (unsigned long long)parser->content_length != parser->remaining) {
+            return HTTP_PARSER_ERROR_CONTENT_LENGTH;
+        }
+        parser->content_length = (long long)parser->remaining;
+        parser->remaining = 0;
+    } else if (parser->header_kind != HEADER_OTHER) {
+        token_done(parser);
+    }
+
+    parser->state = S_HEADER_START;
+    int (*report)(HttpParser*, size_t, size_t, size_t, size_t) =
+        parser->trailers ? parser->callbacks->on_trailer : parser->callbacks->on_header;
+    if (is_interim(parser) || !report) return HTTP_PARSER_OK;
+    return report(parser, parser->name_offset, parser->name_len, parser->mark, parser->value_end - parser->mark)
+           ? HTTP_PARSER_ERROR_CALLBACK : HTTP_PARSER_OK;
+}
+
+static HttpParserError message_done(HttpParser *parser) {
+    parser->state = S_DONE;
+    parser->message_complete = 1;
+    if (parser->callbacks->on_message_complete && parser->callbacks->on_message_complete(parser)) {
+        return HTTP_PARSER_ERROR_CALLBACK;
+    }
+    return HTTP_PARSER_OK;
+}
+
+/* Picks how the body is framed once the blank line after the headers is in */
+static HttpParserError headers_done(HttpParser *parser) {
+    if (is_interim(parser)) {
+        reset_message(parser);
+        parser->state = S_START;
+        return HTTP_PARSER_OK;
+    }
+
+    if (parser->callbacks->on_headers_complete && parser->callbacks->on_headers_complete(parser)) {
+        return HTTP_PARSER_ERROR_CALLBACK;
+    }
+
+    parser->remaining = 0;
+    parser->digits = 0;
+    if (has_no_body(parser)) {
+        parser->state = S_DONE;
+    } else if (parser->chunked) {
+        parser->state = S_CHUNK_SIZE;
+    } else if (parser->content_length > 0) {
+        parser->remaining = (unsigned long long)parser->content_length;
+        parser->state = S_BODY_IDENTITY;
+    } else if (parser->content_length == 0) {
+        parser->state = S_DONE;
+    } else {
+        parser->state = S_BODY_CLOSE;
+    }
+    return HTTP_PARSER_OK;
+}
+
+void http_parser_init(HttpParser *parser, const HttpParserCallbacks *callbacks, void *userdata, int head_request) {
+    memset(parser, 0, sizeof(HttpParser));
+    parser->callbacks = callbacks;
+    parser->userdata = userdata;
+    parser->head_request = head_request;
+    parser->state = S_START;
+    reset_message(parser);
+}
+
+#define OFFSET() (base + (size_t)(p - data))
+#define FAIL(code) do { parser->error = (code); goto fail; } while (0)
+#define CHECK(call) do { parser->offset = OFFSET() + 1; HttpParserError err_ = (call); if (err_) FAIL(err_); } while (0)
+
+size_t http_parser_execute(HttpParser *parser, const char *data, size_t len) {
+    if (parser->state == S_DONE || parser->state == S_ERROR) return 0;
+
+    const char *p = data;
+    const char *end = data + len;
+    size_t base = parser->offset;
+    const char *body = raw_body(parser->state) ? data : NULL;  // Body bytes not reported yet
+    HttpParserError err;
+
+    for (; p < end; p++) {
+        char c = *p;
+        switch (parser->state) {
+        case S_START:
+            if (c == '\r' || c == '\n') break;
+            parser->message_offset = OFFSET();
+            parser->digits = 0;
+            parser->state = S_PROTOCOL;
+            /* fall through */
+        case S_PROTOCOL:
+            if (c != "HTTP/"[parser->digits]) FAIL(HTTP_PARSER_ERROR_STATUS_LINE);
+            if (++parser->digits == 5) {
+                parser->http_major = 0;
+                parser->digits = 0;
+                parser->state = S_MAJOR;
+            }
+            break;
+        case S_MAJOR:
+            if (c == '.' && parser->digits) {
+                parser->http_minor = 0;
+                parser->digits = 0;
+                parser->state = S_MINOR;
+                break;
+            }
+            if (!is_digit(c) || ++parser->digits > 3) FAIL(HTTP_PARSER_ERROR_STATUS_LINE);
+            parser->http_major = parser->http_major * 10 + (c - '0');
+            break;
+        case S_MINOR:
+            if (c == ' ' && parser->digits) {
+                parser->status_code = 0;
+                parser->digits = 0;
+                parser->state = S_STATUS_CODE;
+                break;
+            }
+            if (!is_digit(c) || ++parser->digits > 3) FAIL(HTTP_PARSER_ERROR_STATUS_LINE);
+            parser->http_minor = parser->http_minor * 10 + (c - '0');
+            break;
+        case S_STATUS_CODE:
+            if (is_digit(c) && parser->digits < 3) {
+                parser->status_code = parser->status_code * 10 + (c - '0');
+                parser->digits++;
+                break;
+            }
+            if (parser->digits != 3 || parser->status_code < 100) FAIL(HTTP_PARSER_ERROR_STATUS_LINE);
+            if (c == ' ') {
+                parser->mark = OFFSET() + 1;
+                parser->state = S_REASON;
+                break;
+            }
+            parser->mark = OFFSET();
+            /* fall through */
+        case S_REASON: {
+            const char *stop = http_scan_line(p, end);
+            if (stop == end) {
+                p = end - 1;
+                break;
+            }
+            p = stop;
+            c = *p;
+            if (c != '\r' && c != '\n') FAIL(HTTP_PARSER_ERROR_STATUS_LINE);
+            parser->value_end = OFFSET();
+            parser->state = S_STATUS_LF;
+            if (c == '\r') break;
+            goto status_line_end;
+        }
+        case S_STATUS_LF:
+            if (c != '\n') FAIL(HTTP_PARSER_ERROR_STATUS_LINE);
+        status_line_end:
+            CHECK(status_line_done(parser));
+            break;
+        case S_HEADER_START:
+            if (c == '\r') {
+                parser->state = S_HEADERS_LF;
+                break;
+            }
+            if (c == '\n') goto headers_end;
+            if (OFFSET() - (parser->trailers ? parser->trailer_offset : parser->message_offset) > MAX_HEADER_BYTES) {
+                FAIL(HTTP_PARSER_ERROR_HEADER);
+            }
+            parser->mark = OFFSET();
+            parser->name_match = KNOWN_MASK;
+            parser->state = S_HEADER_NAME;
+            /* fall through */
+        case S_HEADER_NAME: {
+            /* The colon is found in bulk; the name bytes before it are then checked
+               against the tchar table, and matched while a known name still fits */
+            const char *colon = http_scan_name(p, end);
+            for (; p < colon; p++) {
+                if (!is_token_char(*p)) FAIL(HTTP_PARSER_ERROR_HEADER);
+                if (parser->name_match) {
+                    parser->name_match = match_step(parser->name_match, known_headers, OFFSET() - parser->mark, *p);
+                }
+            }
+            if (p == end) {
+                p = end - 1;
+                break;
+            }
+            c = *p;
+            if (c == ':') {
+                if (OFFSET() == parser->mark) FAIL(HTTP_PARSER_ERROR_HEADER);
+                parser->name_offset = parser->mark;
+                parser->name_len = OFFSET() - parser->mark;
+                /* Trailer fields cannot change the framing of the message they end */
+                parser->header_kind = parser->trailers ? HEADER_OTHER
+                                                       : match_word(parser->name_match, known_headers, parser->name_len);
+                parser->token_match = KNOWN_MASK;
+                parser->token_len = 0;
+                parser->token_params = 0;
+                parser->digits = 0;
+                if (parser->header_kind == HEADER_CONTENT_LENGTH) parser->remaining = 0;
+                parser->state = S_VALUE_START;
+                break;
+            }
+            FAIL(HTTP_PARSER_ERROR_HEADER);
+        }
+        case S_VALUE_START:
+            if (c == ' ' || c == '\t') break;
+            parser->mark = OFFSET();
+            parser->value_end = parser->mark;
+            parser->state = S_VALUE;
+            /* fall through */
+        case S_VALUE:
+            if (parser->header_kind == HEADER_OTHER) {
+                /* Only the framing headers need every byte; skip the others to the end of the line */
+                const char *stop = http_scan_line(p, end);
+                const char *last = stop;
+                while (last > p && (last[-1] == ' ' || last[-1] == '\t')) last--;
+                if (last > p) parser->value_end = base + (size_t)(last - data);
+                if (stop == end) {
+                    p = end - 1;
+                    break;
+                }
+                p = stop;
+                c = *p;
+            }
+            if (c == '\r') {
+                parser->state = S_HEADER_LF;
+                break;
+            }
+            if (c == '\n') goto header_end;
+            if (is_ctl(c)) FAIL(HTTP_PARSER_ERROR_HEADER);
+            if ((err = value_byte(parser, c, OFFSET())) != HTTP_PARSER_OK) FAIL(err);
+            if (c != ' ' && c != '\t') parser->value_end = OFFSET() + 1;
+            break;
+        case S_HEADER_LF:
+            if (c != '\n') FAIL(HTTP_PARSER_ERROR_HEADER);
+        header_end:
+            CHECK(header_done(parser));
+            break;
+        case S_HEADERS_LF:
+            if (c != '\n') FAIL(HTTP_PARSER_ERROR_HEADER);
+        headers_end:
+            if (parser->trailers) {
+                p++;
+                goto message_end;
+            }
+            CHECK(headers_done(parser));
+            if (parser->state == S_DONE) {
+                p++;
+                goto message_end;
+            }
+            if (raw_body(parser->state)) body = p + 1;
+            break;
+        case S_BODY_IDENTITY: {
+            size_t n = (size_t)(end - p) < parser->remaining ? (size_t)(end - p) : (size_t)parser->remaining;
+            parser->remaining -= n;
+            p += n;
+            if (!parser->remaining) goto message_end;
+            p--;
+            break;
+        }
+        case S_BODY_CLOSE:
+            p = end - 1;
+            break;
+        case S_CHUNK_SIZE: {
+            /* One table lookup per digit, in a loop of its own over the slice */
+            unsigned char digit;
+            while ((digit = hex_digits[(unsigned char)*p]) != 0) {
+                if (parser->remaining >> 60) FAIL(HTTP_PARSER_ERROR_CHUNK);
+                parser->remaining = parser->remaining << 4 | (unsigned)(digit - 1);
+                parser->digits++;
+                if (++p == end) break;
+            }
+            if (p == end) {
+                p = end - 1;
+                break;
+            }
+            c = *p;
+            if (!parser->digits) FAIL(HTTP_PARSER_ERROR_CHUNK);
+            if (c == ';' || c == ' ' || c == '\t') {
+                parser->state = S_CHUNK_EXT;
+            } else if (c == '\r') {
+                parser->state = S_CHUNK_SIZE_LF;
+            } else if (c == '\n') {
+                goto chunk_size_end;
+            } else {
+                FAIL(HTTP_PARSER_ERROR_CHUNK);
+            }
+            break;
+        }
+        case S_CHUNK_EXT:
+            if (c == '\r') parser->state = S_CHUNK_SIZE_LF;
+            else if (c == '\n') goto chunk_size_end;
+            break;
+        case S_CHUNK_SIZE_LF:
+            if (c != '\n') FAIL(HTTP_PARSER_ERROR_CHUNK);
+        chunk_size_end:
+            parser->digits = 0;
+            if (parser->remaining) {
+                parser->state = S_CHUNK_DATA;
+            } else {
+                /* The last chunk: trailer fields, if any, and a blank line follow */
+                parser->trailers = 1;
+                parser->trailer_offset = OFFSET() + 1;
+                parser->state = S_HEADER_START;
+            }
+            break;
+        case S_CHUNK_DATA: {
+            size_t n = (size_t)(end - p) < parser->remaining ? (size_t)(end - p) : (size_t)parser->remaining;
+            parser->remaining -= n;
+            parser->offset = OFFSET() + n;
+            if (parser->callbacks->on_body && parser->callbacks->on_body(parser, p, n)) FAIL(HTTP_PARSER_ERROR_CALLBACK);
+            p += n - 1;
+            if (!parser->remaining) parser->state = S_CHUNK_DATA_CR;
+            break;
+        }
+        case S_CHUNK_DATA_CR:
+            if (c == '\r') {
+                parser->state = S_CHUNK_DATA_LF;
+                break;
+            }
+            if (c != '\n') FAIL(HTTP_PARSER_ERROR_CHUNK);
+            parser->state = S_CHUNK_SIZE;
+            break;
+        case S_CHUNK_DATA_LF:
+            if (c != '\n') FAIL(HTTP_PARSER_ERROR_CHUNK);
+            parser->state = S_CHUNK_SIZE;
+            break;
+        }
+    }
+
+    parser->offset = OFFSET();
+    if (body && p > body && parser->callbacks->on_body && parser->callbacks->on_body(parser, body, p - body)) {
+        FAIL(HTTP_PARSER_ERROR_CALLBACK);
+    }
+    return len;
+
+message_end:
+    /* p is right after the last byte of the message */
+    parser->offset = OFFSET();
+    if (body && p > body && parser->callbacks->on_body && parser->callbacks->on_body(parser, body, p - body)) {
+        FAIL(HTTP_PARSER_ERROR_CALLBACK);
+    }
+    if ((err = message_done(parser)) != HTTP_PARSER_OK) FAIL(err);
+    return p - data;
+
+fail:
+    parser->state = S_ERROR;
+    parser->offset = OFFSET();
+    return p - data;
+}
+
+size_t http_parser_skip(HttpParser *parser, size_t len) {
+    if (parser->state == S_BODY_CLOSE) {
+        parser->offset += len;
+        return len;
+    }
+    if (parser->state != S_BODY_IDENTITY) return 0;
+
+    if (len > parser->remaining) len = (size_t)parser->remaining;
+    parser->remaining -= len;
+    parser->offset += len;
+    if (!parser->remaining && message_done(parser) != HTTP_PARSER_OK) {
+        parser->error = HTTP_PARSER_ERROR_CALLBACK;
+        parser->state = S_ERROR;
+    }
+    return len;
+}
+
+int http_parser_finish(HttpParser *parser) {
+    if (parser->state == S_DONE) return 0;
+    if (parser->state == S_BODY_CLOSE) {
+        if (message_done(parser) == HTTP_PARSER_OK) return 0;
+        parser->error = HTTP_PARSER_ERROR_CALLBACK;
+    } else if (parser->state != S_ERROR) {
+        parser->error = HTTP_PARSER_ERROR_TRUNCATED;
+    }
+    parser->state = S_ERROR;
+    return -1;
+}
+
+int http_parser_keep_alive(const HttpParser *parser) {
+    if (parser->connection_close || parser->status_code == 101) return 0;
+    if (parser->http_major != 1) return 0;
+    if (parser->http_minor == 0 && !parser->connection_keep_alive) return 0;
+    return has_no_body(parser) || parser->chunked || parser->content_length >= 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file http_pool.c
+ * @brief Implementation of the keep-alive connection pool in C.
+ *
+ * This file contains the implementation of the connection pool shared by
+ * the http requests functions.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Idle connections live in a single list protected by a mutex, so the pool
+ * can be used from several threads. Expired connections are pruned whenever
+ * the pool is touched, and a connection the peer already closed is detected
+ * with a non-blocking peek before it is handed out.
+ * Closing a TLS connection sends close_notify only while the peer still
+ * listens, with SIGPIPE blocked in the closing thread, so that a peer that
+ * hung up meanwhile cannot kill a program that did not ignore the signal.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http.h"
+#include "http_pool.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static HttpConnection *idle_list = NULL;
+static size_t max_idle_per_host = 4;
+static int idle_timeout = 30;
+
+static int same_origin(const HttpConnection *conn, const char *scheme, const char *host, int port) {
+    return conn->port == port &&
+           strcmp(conn->scheme, scheme) == 0 &&
+           strcmp(conn->host, host) == 0;
+}
+
+/* A pooled connection is only usable if the peer has neither closed it nor sent anything unsolicited */
+static int connection_is_alive(const HttpConnection *conn) {
+    char c;
+    ssize_t n = recv(conn->sockfd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+/* Unlinks expired connections into *expired; called with pool_lock held */
+static void prune_expired(time_t now, HttpConnection **expired) {
+    HttpConnection **link = &idle_list;
+    while (*link) {
+        HttpConnection *conn = *link;
+        if (now - conn->last_used >= idle_timeout) {
+            *link = conn->next;
+            conn->next = *expired;
+            *expired = conn;
+        } else {
+            link = &conn->next;
+        }
+    }
+}
+
+/* Sends close_notify with SIGPIPE blocked, then takes back the SIGPIPE it raised, if any */
+static void shutdown_tls(SSL *ssl) {
+    sigset_t pipe_set, old_set, pending;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    sigpending(&pending);
+    int was_pending = sigismember(&pending, SIGPIPE);
+
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+    SSL_shutdown(ssl);
+    sigpending(&pending);
+    if (!was_pending && sigismember(&pending, SIGPIPE)) {
+        struct timespec no_wait = { 0, 0 };
+        sigtimedwait(&pipe_set, NULL, &no_wait);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+}
+
+static void close_all(HttpConnection *list) {
+    while (list) {
+        HttpConnection *next = list->next;
+        http_connection_close(list);
+        list = next;
+    }
+}
+
+HttpConnection* http_connection_new(int sockfd, SSL *ssl, const char *scheme, const char *host, int port) {
+    HttpConnection *conn = calloc(1, sizeof(HttpConnection));
+    if (!conn) return NULL;
+
+    conn->scheme = strdup(scheme);
+    conn->host = strdup(host);
+    if (!conn->scheme || !conn->host) {
+        free(conn->scheme);
+        free(conn->host);
+        free(conn);
+        return NULL;
+    }
+
+    conn->sockfd = sockfd;
+    conn->ssl = ssl;
+    conn->port = port;
+    return conn;
+}
+
+void http_connection_close(HttpConnection *conn) {
+    if (!conn) return;
+    if (conn->ssl) {
+        /* A peer that closed its side would only answer close_notify with a reset */
+        if (!connection_is_alive(conn)) SSL_set_quiet_shutdown(conn->ssl, 1);
+        shutdown_tls(conn->ssl);
+        SSL_free(conn->ssl);
+    }
+    close(conn->sockfd);
+    free(conn->scheme);
+    free(conn->host);
+    free(conn);
+}
+
+HttpConnection* http_pool_acquire(const char *scheme, const char *host, int port) {
+    HttpConnection *expired = NULL;
+    HttpConnection *found = NULL;
+
+    pthread_mutex_lock(&pool_lock);
+    prune_expired(time(NULL), &expired);
+    for (HttpConnection **link = &idle_list; *link; ) {
+        HttpConnection *conn = *link;
+        if (!same_origin(conn, scheme, host, port)) {
+            link = &conn->next;
+            continue;
+        }
+        *link = conn->next;
+        if (connection_is_alive(conn)) {
+            found = conn;
+            break;
+        }
+        conn->next = expired;
+        expired = conn;
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    close_all(expired);
+    if (found) {
+        found->next = NULL;
+        found->reused = 1;
+    }
+    return found;
+}
+
+void http_pool_release(HttpConnection *conn) {
+    if (!conn) return;
+
+    HttpConnection *expired = NULL;
+    time_t now = time(NULL);
+    conn->last_used = now;
+
+    pthread_mutex_lock(&pool_lock);
+    prune_expired(now, &expired);
+
+    /* The list is kept most-recent first, so the last match is the oldest one */
+    size_t same_host = 0;
+    HttpConnection **oldest = NULL;
+    for (HttpConnection **link = &idle_list; *link; link = &(*link)->next) {
+        if (same_origin(*link, conn->scheme, conn->host, conn->port)) {
+            same_host++;
+            oldest = link;
+        }
+    }
+    if (max_idle_per_host == 0) {
+        conn->next = expired;
+        expired = conn;
+    } else {
+        if (same_host >= max_idle_per_host && oldest) {
+            HttpConnection *victim = *oldest;
+            *oldest = victim->next;
+            victim->next = expired;
+            expired = victim;
+        }
+        conn->next = idle_list;
+        idle_list = conn;
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    close_all(expired);
+}
+
+void http_pool_clear(void) {
+    pthread_mutex_lock(&pool_lock);
+    HttpConnection *list = idle_list;
+    idle_list = NULL;
+    pthread_mutex_unlock(&pool_lock);
+
+    close_all(list);
+}
+
+void http_pool_set_limits(size_t max_idle, int timeout_seconds) {
+    HttpConnection *expired = NULL;
+
+    pthread_mutex_lock(&pool_lock);
+    max_idle_per_host = max_idle;
+    idle_timeout = timeout_seconds;
+    prune_expired(time(NULL), &expired);
+    pthread_mutex_unlock(&pool_lock);
+
+    close_all(expired);
+}
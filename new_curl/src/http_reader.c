@@ -0,0 +1,350 @@
+/**
+ * @file http_reader.c
+ * @brief Implementation of the HTTP response reader in C.
+ *
+ * This file contains the implementation of the reader that collects a
+ * complete HTTP/1.1 response from a connection.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * The buffer starts at 8192 bytes. Once the header block is in and the
+ * server announced a Content-Length, the buffer is resized once to hold
+ * the whole message, plus the response structure that will take the buffer
+ * over, and reads are capped to the bytes still missing.
+ * Without a length (chunked or close-delimited bodies) it doubles as it
+ * fills up. Each committed read is handed to the parser once, so nothing
+ * is scanned twice however the response is split. When streaming, body
+ * bytes are passed on from the parser's callback and dropped right after,
+ * so reads land in the same window after the header block every time.
+ *
+ * Chunked bodies are decoded in place: each run of chunk data the parser
+ * reports is moved down to the end of the body decoded so far, over the
+ * framing already parsed, so the body ends up contiguous in the receive
+ * buffer without a second one. Trailer fields are packed the same way
+ * after the body and its NUL, and listed with the headers.
+ *
+ * Compressed bodies cannot be decoded in place, since they grow. Each read
+ * is decoded as soon as the parser reports it, straight into a buffer of
+ * their own presized from the compressed length, or, when streaming, into
+ * one window allocated with the decoder and passed to the sink every time
+ * it fills. The compressed bytes are then dropped like streamed ones.
+ * The buffer never grows past the maximum decoded size and a few pages:
+ * a body decoding to more fails the response, as a few megabytes of
+ * compressed zeros would otherwise expand to gigabytes.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_reader.h"
+#include "http_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define READER_INITIAL_SIZE 8192
+#define READER_MIN_READ 4096
+#define READER_INITIAL_FIELDS 16
+#define READER_DEFAULT_WINDOW (64 * 1024)
+#define DECODED_INITIAL_SIZE (64 * 1024)
+#define DECODED_MAX_PRESIZE (64 * 1024 * 1024)
+#define DECODED_MIN_ROOM 4096
+#define DECODED_DEFAULT_MAX (256 * 1024 * 1024)
+
+static HttpReader* reader_of(HttpParser *parser) {
+    return (HttpReader*)((char*)parser - offsetof(HttpReader, parser));
+}
+
+static int resize(HttpReader *reader, size_t cap) {
+    char *data = realloc(reader->data, cap + 1);
+    if (!data) return -1;
+    reader->data = data;
+    reader->cap = cap;
+    return 0;
+}
+
+static int on_header(HttpParser *parser, size_t name_offset, size_t name_len, size_t value_offset, size_t value_len) {
+    HttpReader *reader = reader_of(parser);
+    if (reader->field_count == reader->field_cap) {
+        size_t cap = reader->field_cap ? reader->field_cap * 2 : READER_INITIAL_FIELDS;
+        HttpReaderField *fields = realloc(reader->fields, cap * sizeof(HttpReaderField));
+        if (!fields) return -1;
+        reader->fields = fields;
+        reader->field_cap = cap;
+    }
+
+    HttpReaderField *field = &reader->fields[reader->field_count++];
+    field->name_offset = name_offset;
+    field->name_len = name_len;
+    field->value_offset = value_offset;
+    field->value_len = value_len;
+    return 0;
+}
+
+/* Sets up a decoder if the body has a Content-Encoding this build undoes */
+static int start_decoding(HttpReader *reader) {
+    HttpCoding coding = HTTP_CODING_IDENTITY;
+    for (size_t i = 0; i < reader->field_count; i++) {
+        const HttpReaderField *field = &reader->fields[i];
+        if (field->name_len == 16 && strncasecmp(reader->data + field->name_offset, "content-encoding", 16) == 0) {
+            coding = http_decode_coding(reader->data + field->value_offset, field->value_len);
+        }
+    }
+    if (coding == HTTP_CODING_IDENTITY || coding == HTTP_CODING_UNSUPPORTED) return 0;
+
+    size_t cap = reader->window;
+    if (!reader->sink) {
+        /* The compressed bytes are read through a window as when streaming;
+           compressed text commonly grows four to ten times */
+        reader->window = READER_DEFAULT_WINDOW;
+        cap = DECODED_INITIAL_SIZE;
+        if (reader->content_length > 0 && (unsigned long long)reader->content_length < DECODED_MAX_PRESIZE / 4) {
+            if ((size_t)reader->content_length * 4 > cap) cap = (size_t)reader->content_length * 4;
+        }
+        if (cap > reader->max_decoded + DECODED_MIN_ROOM) cap = reader->max_decoded + DECODED_MIN_ROOM;
+    }
+    reader->decoder = http_decoder_new(coding);
+    reader->decoded = malloc(cap + 1);
+    if (!reader->decoder || !reader->decoded) return -1;
+    reader->decoded_cap = cap;
+    return 0;
+}
+
+static int on_headers_complete(HttpParser *parser) {
+    HttpReader *reader = reader_of(parser);
+    reader->status_code = parser->status_code;
+    reader->headers_start = parser->message_offset;
+    reader->headers_len = parser->offset - parser->message_offset;
+    reader->chunked = parser->chunked;
+    reader->content_length = parser->chunked ? -1 : parser->content_length;
+    reader->reserve = http_response_size(0, reader->field_count);
+    if (reader->decode && !parser->head_request && start_decoding(reader) < 0) return -1;
+    if (reader->sink_headers && reader->sink_headers(reader->sink_userdata) != 0) {
+        reader->sink_failed = 1;
+        return -1;
+    }
+    return 0;
+}
+
+/* Decodes body bytes after the decoded body kept so far, or into the window
+   passed to the sink each time the decoder stops */
+static int decode_body(HttpReader *reader, const char *data, size_t len) {
+    for (;;) {
+        if (!reader->sink && reader->decoded_cap - reader->decoded_len < DECODED_MIN_ROOM) {
+            /* Up to the maximum and a little more, to tell a body just at it from a larger one */
+            size_t cap = reader->decoded_cap * 2;
+            if (cap > reader->max_decoded + DECODED_MIN_ROOM) cap = reader->max_decoded + DECODED_MIN_ROOM;
+            char *decoded = realloc(reader->decoded, cap + 1);
+            if (!decoded) return -1;
+            reader->decoded = decoded;
+            reader->decoded_cap = cap;
+        }
+        char *out = reader->sink ? reader->decoded : reader->decoded + reader->decoded_len;
+        size_t room = reader->sink ? reader->decoded_cap : reader->decoded_cap - reader->decoded_len;
+        size_t produced = room;
+        if (http_decoder_run(reader->decoder, &data, &len, out, &produced) < 0) return -1;
+
+        if (!reader->sink) {
+            reader->decoded_len += produced;
+            if (reader->decoded_len > reader->max_decoded) {
+                reader->too_large = 1;
+                return -1;
+            }
+        } else if (produced && reader->sink(out, produced, reader->sink_userdata) != 0) {
+            reader->sink_failed = 1;
+            return -1;
+        }
+        if (!len && produced < room) return 0;
+    }
+}
+
+/* Body bytes are already in place: count them (packing chunk data after
+   the body decoded so far), or pass them on when streaming */
+static int on_body(HttpParser *parser, const char *data, size_t len) {
+    HttpReader *reader = reader_of(parser);
+    reader->body_received += len;
+    if (reader->decoder) return decode_body(reader, data, len);
+    if (!reader->sink) {
+        char *body_end = reader->data + reader->headers_start + reader->headers_len + reader->body_len;
+        if (data != body_end) memmove(body_end, data, len);
+        reader->body_len += len;
+        return 0;
+    }
+    if (reader->sink(data, len, reader->sink_userdata) != 0) {
+        reader->sink_failed = 1;
+        return -1;
+    }
+    return 0;
+}
+
+/* Packs a trailer field after the body and its NUL, where the response
+   built from the buffer keeps it */
+static int on_trailer(HttpParser *parser, size_t name_offset, size_t name_len, size_t value_offset, size_t value_len) {
+    HttpReader *reader = reader_of(parser);
+    size_t offset = reader->headers_start + reader->headers_len + reader->body_len + 1 + reader->trailers_len;
+    memmove(reader->data + offset, reader->data + (name_offset - reader->dropped), name_len);
+    memmove(reader->data + offset + name_len, reader->data + (value_offset - reader->dropped), value_len);
+    reader->trailers_len += name_len + value_len;
+    return on_header(parser, offset, name_len, offset + name_len, value_len);
+}
+
+static int on_message_complete(HttpParser *parser) {
+    HttpReader *reader = reader_of(parser);
+    /* A compressed body cut short decodes to a truncated one */
+    if (reader->decoder && !http_decoder_done(reader->decoder)) return -1;
+    reader->complete = 1;
+    reader->keep_alive = http_parser_keep_alive(parser);
+    return 0;
+}
+
+static const HttpParserCallbacks reader_callbacks = {
+    .on_header = on_header,
+    .on_headers_complete = on_headers_complete,
+    .on_body = on_body,
+    .on_trailer = on_trailer,
+    .on_message_complete = on_message_complete,
+};
+
+int http_reader_init(HttpReader *reader, const char *method) {
+    memset(reader, 0, sizeof(HttpReader));
+    reader->content_length = -1;
+    http_parser_init(&reader->parser, &reader_callbacks, NULL, strcmp(method, "HEAD") == 0);
+    if (resize(reader, READER_INITIAL_SIZE) < 0) return -1;
+    reader->data[0] = '\0';
+    return 0;
+}
+
+void http_reader_decode(HttpReader *reader, size_t max_decoded) {
+    reader->decode = http_decode_accept() != NULL;
+    reader->max_decoded = max_decoded ? max_decoded : DECODED_DEFAULT_MAX;
+}
+
+void http_reader_stream(HttpReader *reader, HttpBodyCallback sink, void *userdata, size_t window) {
+    reader->sink = sink;
+    reader->sink_userdata = userdata;
+    reader->window = window ? window : READER_DEFAULT_WINDOW;
+}
+
+void http_reader_on_headers(HttpReader *reader, HttpReaderHeadersCallback callback) {
+    reader->sink_headers = callback;
+}
+
+/* Body bytes still expected when the server announced a length */
+static size_t body_left(const HttpReader *reader) {
+    unsigned long long length = (unsigned long long)reader->content_length;
+    return length > reader->body_received ? (size_t)(length - reader->body_received) : 0;
+}
+
+char* http_reader_buffer(HttpReader *reader, size_t *avail) {
+    if (reader->headers_len && (reader->sink || reader->decoder)) {
+        /* The window right after the header block is reused for every read */
+        *avail = reader->cap - reader->len;
+        if (*avail > reader->window) *avail = reader->window;
+        if (reader->content_length >= 0 && *avail > body_left(reader)) *avail = body_left(reader);
+        return reader->data + reader->len;
+    }
+
+    if (reader->headers_len && reader->content_length >= 0) {
+        size_t total = reader->headers_start + reader->headers_len + (size_t)reader->content_length;
+        *avail = total > reader->len ? total - reader->len : 0;
+        return reader->data + reader->len;
+    }
+
+    if (reader->cap - reader->len < READER_MIN_READ && resize(reader, reader->cap * 2) < 0) return NULL;
+    *avail = reader->cap - reader->len;
+    return reader->data + reader->len;
+}
+
+int http_reader_commit(HttpReader *reader, size_t n) {
+    size_t start = reader->len;
+    reader->len += n;
+    reader->data[reader->len] = '\0';
+
+    if (reader->complete) return 1;
+    http_parser_execute(&reader->parser, reader->data + start, n);
+    if (reader->parser.error != HTTP_PARSER_OK) return -1;
+    if (reader->complete) return 1;
+
+    if (!reader->headers_len) return 0;
+
+    /* Resizing is done here rather than from the callbacks, which run while
+       the parser walks the buffer */
+    size_t body_offset = reader->headers_start + reader->headers_len;
+    if (reader->sink || reader->decoder) {
+        /* Streamed or decoded bytes are gone; the next read reuses their room, unless
+           it holds the start of the trailers, which are kept until their end */
+        if (!reader->parser.trailers) {
+            reader->dropped += reader->len - body_offset;
+            reader->len = body_offset;
+            reader->data[reader->len] = '\0';
+        }
+        size_t total = reader->len + reader->window + reader->reserve;
+        if (total > reader->cap && resize(reader, total) < 0) return -1;
+    } else if (reader->content_length > 0) {
+        /* Size the buffer for the whole message, and the response laid out after it */
+        size_t total = body_offset + (size_t)reader->content_length + reader->reserve;
+        if (total > reader->cap && resize(reader, total) < 0) return -1;
+    }
+    return 0;
+}
+
+size_t http_reader_raw_left(const HttpReader *reader) {
+    if (!reader->headers_len || !reader->sink || reader->complete || reader->chunked || reader->decoder) return 0;
+    return reader->content_length >= 0 ? body_left(reader) : SIZE_MAX;
+}
+
+int http_reader_skip(HttpReader *reader, size_t n) {
+    if (http_parser_skip(&reader->parser, n) != n) return -1;
+    reader->body_received += n;
+    if (reader->parser.error != HTTP_PARSER_OK) return -1;
+    return reader->complete;
+}
+
+int http_reader_close(HttpReader *reader) {
+    if (!reader->complete) http_parser_finish(&reader->parser);
+    reader->keep_alive = 0;
+    return reader->complete;
+}
+
+char* http_reader_take(HttpReader *reader, size_t size) {
+    if (size > reader->cap && resize(reader, size) < 0) return NULL;
+    char *data = reader->data;
+    reader->data = NULL;
+    return data;
+}
+
+char* http_reader_take_decoded(HttpReader *reader, size_t size) {
+    if (size > reader->decoded_cap) {
+        char *decoded = realloc(reader->decoded, size);
+        if (!decoded) return NULL;
+        reader->decoded = decoded;
+    }
+    char *decoded = reader->decoded;
+    reader->decoded = NULL;
+    return decoded;
+}
+
+void http_reader_free(HttpReader *reader) {
+    free(reader->data);
+    free(reader->fields);
+    free(reader->decoded);
+    http_decoder_free(reader->decoder);
+    reader->data = NULL;
+    reader->fields = NULL;
+    reader->decoded = NULL;
+    reader->decoder = NULL;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file http_scan.c
+ * @brief Implementation of the vectorized header scanning in C.
+ *
+ * This file contains the scalar, SSE2 and AVX2 variants of the header line
+ * and name scanners and the selection of the one to use.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * A byte stops the scan when it is below 0x20 and not HT, or is DEL, or
+ * is the extra byte of the scan: the colon for names, DEL again for lines.
+ * The vector variants test a whole block with unsigned compares, turn the
+ * result into a bit mask and take its lowest set bit. The tail shorter than
+ * a block is handled by the scalar loop. The AVX2 variant is compiled with
+ * a target attribute, so the rest of the program needs no -mavx2 and runs
+ * on CPUs without it.
+ *
+ * SSE2 is the default on x86-64. Header lines are mostly shorter than 32
+ * bytes, so the AVX2 loop often ends in its 16-byte tail; make bench shows
+ * it scanning a typical header block slower than SSE2, so it is only used
+ * when asked for.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_scan.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
+/* Byte a line scan stops at besides the control bytes: DEL, which already does */
+#define LINE_EXTRA 0x7f
+
+typedef const char* (*ScanFunc)(const char *p, const char *end, char extra);
+
+static int is_stop(unsigned char c, char extra) {
+    return (c < 0x20 && c != '\t') || c == 0x7f || c == (unsigned char)extra;
+}
+
+static const char* scan_scalar(const char *p, const char *end, char extra) {
+    while (p < end && !is_stop((unsigned char)*p, extra)) p++;
+    return p;
+}
+
+#ifdef HAVE_X86_SIMD
+static const char* scan_sse2(const char *p, const char *end, char extra) {
+    const __m128i ctl = _mm_set1_epi8(0x1f);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i del = _mm_set1_epi8(0x7f);
+    const __m128i more = _mm_set1_epi8(extra);
+
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        /* max(v, 0x1f) == 0x1f exactly when v <= 0x1f, unsigned */
+        __m128i low = _mm_cmpeq_epi8(_mm_max_epu8(v, ctl), ctl);
+        __m128i stop = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi8(v, tab), low),
+                                    _mm_or_si128(_mm_cmpeq_epi8(v, del), _mm_cmpeq_epi8(v, more)));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(stop);
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+    return scan_scalar(p, end, extra);
+}
+
+__attribute__((target("avx2")))
+static const char* scan_avx2(const char *p, const char *end, char extra) {
+    const __m256i ctl = _mm256_set1_epi8(0x1f);
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i del = _mm256_set1_epi8(0x7f);
+    const __m256i more = _mm256_set1_epi8(extra);
+
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        __m256i low = _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctl), ctl);
+        __m256i stop = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(v, tab), low),
+                                       _mm256_or_si256(_mm256_cmpeq_epi8(v, del), _mm256_cmpeq_epi8(v, more)));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(stop);
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return scan_sse2(p, end, extra);
+}
+#endif
+
+static ScanFunc scan_func(HttpScanImpl impl) {
+    switch (impl) {
+#ifdef HAVE_X86_SIMD
+    case HTTP_SCAN_SSE2:
+        return scan_sse2;
+    case HTTP_SCAN_AVX2:
+        return __builtin_cpu_supports("avx2") ? scan_avx2 : NULL;
+#endif
+    case HTTP_SCAN_SCALAR:
+        return scan_scalar;
+    default:
+        return NULL;
+    }
+}
+
+/* Selected variant; NULL until the first scan picks the best one */
+static ScanFunc selected;
+
+HttpScanImpl http_scan_best(void) {
+    return scan_func(HTTP_SCAN_SSE2) ? HTTP_SCAN_SSE2 : HTTP_SCAN_SCALAR;
+}
+
+int http_scan_use(HttpScanImpl impl) {
+    ScanFunc func = scan_func(impl);
+    if (!func) return -1;
+    __atomic_store_n(&selected, func, __ATOMIC_RELAXED);
+    return 0;
+}
+
+static ScanFunc scanner(void) {
+    ScanFunc func = __atomic_load_n(&selected, __ATOMIC_RELAXED);
+    if (!func) {
+        func = scan_func(http_scan_best());
+        __atomic_store_n(&selected, func, __ATOMIC_RELAXED);
+    }
+    return func;
+}
+
+const char* http_scan_line(const char *p, const char *end) {
+    return scanner()(p, end, LINE_EXTRA);
+}
+
+const char* http_scan_name(const char *p, const char *end) {
+    return scanner()(p, end, ':');
+}
@@ -0,0 +1,474 @@
+/**
+ * @file http_tls.c
+ * @brief Implementation of TLS context management in C.
+ *
+ * This file contains the implementation of the process-wide TLS context
+ * shared by the https requests functions.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * OpenSSL library initialization runs exactly once per process. The client
+ * SSL_CTX is created under a mutex on first use and then only read, which
+ * OpenSSL allows from any number of threads. SSL objects keep their own
+ * reference to the context, so pooled connections stay valid after cleanup.
+ *
+ * Sessions negotiated with an origin are kept in a small in-memory cache
+ * keyed by "host:port" and offered again on the next handshake. With TLS 1.3
+ * the tickets arrive after the handshake, so the cache is filled from the
+ * context's new-session callback rather than right after SSL_connect().
+ *
+ * Optionally the cache is backed by a file, so that short-lived processes
+ * can resume sessions made by earlier ones. Each line holds
+ * "host:port expiry base64(DER)"; readers take a shared flock(), writers an
+ * exclusive one, and expired lines are dropped whenever the file is written.
+ * A TLS 1.3 server sends several tickets per connection: the memory cache
+ * keeps the latest, the file only gets the first, so that each connection
+ * rewrites it once.
+ *
+ * The context asks OpenSSL for kernel TLS. After the handshake OpenSSL
+ * hands the record keys to the kernel when both the kernel and the cipher
+ * support it, so that sendfile() and splice() work on the socket; otherwise
+ * records keep being encrypted in user space and nothing else changes.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_tls.h"
+#include "http.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+
+#define SESSION_CACHE_SIZE 64
+#define SESSION_KEY_SIZE 272
+#define SESSION_FILE_MAX_ENTRIES 256
+
+typedef struct {
+    char key[SESSION_KEY_SIZE];     // "host:port" of the origin
+    SSL_SESSION *session;           // Last resumable session for the origin
+    time_t stored;                  // When the session was stored
+} SessionEntry;
+
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t ctx_lock = PTHREAD_MUTEX_INITIALIZER;
+static SSL_CTX *shared_ctx = NULL;
+static int key_index = -1;
+static int saved_index = -1;    // Set on a connection once the file holds one of its sessions
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static SessionEntry session_cache[SESSION_CACHE_SIZE];
+static unsigned long session_hits = 0;
+static unsigned long session_misses = 0;
+
+static pthread_mutex_t file_lock = PTHREAD_MUTEX_INITIALIZER;
+static char *session_file = NULL;
+
+static void free_key(void *parent, void *ptr, CRYPTO_EX_DATA *ad, int idx, long argl, void *argp) {
+    (void)parent; (void)ad; (void)idx; (void)argl; (void)argp;
+    free(ptr);
+}
+
+static void openssl_init(void) {
+    SSL_library_init();
+    SSL_load_error_strings();
+    OpenSSL_add_ssl_algorithms();
+    key_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, free_key);
+    saved_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+}
+
+/* Returns the entry for key, or NULL; called with cache_lock held */
+static SessionEntry* find_entry(const char *key) {
+    for (size_t i = 0; i < SESSION_CACHE_SIZE; i++) {
+        if (session_cache[i].session && strcmp(session_cache[i].key, key) == 0) {
+            return &session_cache[i];
+        }
+    }
+    return NULL;
+}
+
+/* Stores a session for key, taking ownership of the reference */
+static void store_session(const char *key, SSL_SESSION *session) {
+    pthread_mutex_lock(&cache_lock);
+    SessionEntry *entry = find_entry(key);
+    if (!entry) {
+        entry = &session_cache[0];
+        for (size_t i = 0; i < SESSION_CACHE_SIZE; i++) {
+            if (!session_cache[i].session) {
+                entry = &session_cache[i];
+                break;
+            }
+            if (session_cache[i].stored < entry->stored) entry = &session_cache[i];
+        }
+        snprintf(entry->key, sizeof(entry->key), "%s", key);
+    }
+    SSL_SESSION *old = entry->session;
+    entry->session = session;
+    entry->stored = time(NULL);
+    pthread_mutex_unlock(&cache_lock);
+
+    SSL_SESSION_free(old);
+}
+
+/* Returns a new reference to the cached session for key, or NULL */
+static SSL_SESSION* lookup_session(const char *key) {
+    SSL_SESSION *session = NULL;
+
+    pthread_mutex_lock(&cache_lock);
+    SessionEntry *entry = find_entry(key);
+    if (entry && SSL_SESSION_is_resumable(entry->session)) {
+        session = entry->session;
+        SSL_SESSION_up_ref(session);
+    }
+    pthread_mutex_unlock(&cache_lock);
+
+    return session;
+}
+
+/* Returns the time at which a session stops being resumable */
+static time_t session_expiry(const SSL_SESSION *session) {
+    return (time_t)SSL_SESSION_get_time(session) + (time_t)SSL_SESSION_get_timeout(session);
+}
+
+/* Creates the directories leading to path, like mkdir -p on its dirname */
+static void make_parent_dirs(const char *path) {
+    char *dir = strdup(path);
+    if (!dir) return;
+    for (char *p = strchr(dir + 1, '/'); p; p = strchr(p + 1, '/')) {
+        *p = '\0';
+        mkdir(dir, 0700);
+        *p = '/';
+    }
+    free(dir);
+}
+
+/* Reads the whole session file into a NUL-terminated buffer */
+static char* read_session_file(int fd, size_t *len) {
+    struct stat st;
+    if (fstat(fd, &st) < 0) return NULL;
+
+    char *data = malloc((size_t)st.st_size + 1);
+    if (!data) return NULL;
+
+    size_t total = 0;
+    while (total < (size_t)st.st_size) {
+        ssize_t n = pread(fd, data + total, (size_t)st.st_size - total, (off_t)total);
+        if (n <= 0) break;
+        total += (size_t)n;
+    }
+    data[total] = '\0';
+    *len = total;
+    return data;
+}
+
+/*
+ * Parses one "host:port expiry base64(DER)" line of the session file.
+ * Returns the session, or NULL if the line is malformed or expired.
+ */
+static SSL_SESSION* parse_session_line(char *line, char *key, size_t key_size, time_t now) {
+    char *expiry_str = strchr(line, ' ');
+    if (!expiry_str) return NULL;
+    *expiry_str++ = '\0';
+    char *encoded = strchr(expiry_str, ' ');
+    if (!encoded) return NULL;
+    *encoded++ = '\0';
+
+    if (strtoll(expiry_str, NULL, 10) <= (long long)now) return NULL;
+    if (strlen(line) >= key_size) return NULL;
+    snprintf(key, key_size, "%s", line);
+
+    size_t encoded_len = strlen(encoded);
+    if (encoded_len == 0 || encoded_len % 4 != 0) return NULL;
+    unsigned char *der = malloc(encoded_len / 4 * 3 + 1);
+    if (!der) return NULL;
+    int der_len = EVP_DecodeBlock(der, (const unsigned char *)encoded, (int)encoded_len);
+    /* EVP_DecodeBlock counts padding bytes as data; d2i stops at the end of the DER anyway */
+    const unsigned char *p = der;
+    SSL_SESSION *session = der_len > 0 ? d2i_SSL_SESSION(NULL, &p, der_len) : NULL;
+    free(der);
+    return session;
+}
+
+/* Loads every unexpired session of the session file into the memory cache */
+static void load_session_file(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    size_t len = 0;
+    char *data = NULL;
+    if (flock(fd, LOCK_SH) == 0) {
+        data = read_session_file(fd, &len);
+        flock(fd, LOCK_UN);
+    }
+    close(fd);
+    if (!data) return;
+
+    time_t now = time(NULL);
+    char *saveptr = NULL;
+    for (char *line = strtok_r(data, "\n", &saveptr); line; line = strtok_r(NULL, "\n", &saveptr)) {
+        char key[SESSION_KEY_SIZE];
+        SSL_SESSION *session = parse_session_line(line, key, sizeof(key), now);
+        if (session) store_session(key, session);
+    }
+    free(data);
+}
+
+/* Tells whether a session file line is well formed, unexpired and not for key */
+static int session_line_survives(const char *line, const char *line_end, const char *key, time_t now) {
+    const char *sep = memchr(line, ' ', line_end - line);
+    if (!sep) return 0;
+    if ((size_t)(sep - line) == strlen(key) && strncmp(line, key, sep - line) == 0) return 0;
+    return strtoll(sep + 1, NULL, 10) > (long long)now;
+}
+
+/*
+ * Writes a session for key into the session file, dropping the previous
+ * entry for key, expired entries and the oldest entries beyond the limit.
+ * The file is rewritten in place under an exclusive lock.
+ */
+static void save_session_file(const char *path, const char *key, SSL_SESSION *session) {
+    int der_len = i2d_SSL_SESSION(session, NULL);
+    if (der_len <= 0) return;
+    unsigned char *der = malloc((size_t)der_len);
+    char *encoded = malloc(((size_t)der_len + 2) / 3 * 4 + 1);
+    if (!der || !encoded) {
+        free(der);
+        free(encoded);
+        return;
+    }
+    unsigned char *p = der;
+    i2d_SSL_SESSION(session, &p);
+    EVP_EncodeBlock((unsigned char *)encoded, der, der_len);
+    free(der);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        free(encoded);
+        return;
+    }
+    if (flock(fd, LOCK_EX) < 0) {
+        close(fd);
+        free(encoded);
+        return;
+    }
+
+    size_t len = 0;
+    char *data = read_session_file(fd, &len);
+    size_t out_size = len + strlen(key) + strlen(encoded) + 32;
+    char *out = data ? malloc(out_size) : NULL;
+    if (out) {
+        /* Keep the newest entries: count the survivors first, then skip the oldest ones */
+        time_t now = time(NULL);
+        size_t kept = 0;
+        char *line_end;
+        for (char *line = data; *line; line = line_end + 1) {
+            line_end = strchr(line, '\n');
+            if (!line_end) break;
+            if (session_line_survives(line, line_end, key, now)) kept++;
+        }
+
+        size_t skip = kept >= SESSION_FILE_MAX_ENTRIES ? kept - SESSION_FILE_MAX_ENTRIES + 1 : 0;
+        size_t out_len = 0;
+        for (char *line = data; *line; line = line_end + 1) {
+            line_end = strchr(line, '\n');
+            if (!line_end) break;
+            if (!session_line_survives(line, line_end, key, now)) continue;
+            if (skip > 0) {
+                skip--;
+                continue;
+            }
+            memcpy(out + out_len, line, line_end - line + 1);
+            out_len += line_end - line + 1;
+        }
+        out_len += snprintf(out + out_len, out_size - out_len, "%s %lld %s\n",
+                            key, (long long)session_expiry(session), encoded);
+
+        if (ftruncate(fd, 0) == 0) {
+            size_t written = 0;
+            while (written < out_len) {
+                ssize_t n = pwrite(fd, out + written, out_len - written, (off_t)written);
+                if (n <= 0) break;
+                written += (size_t)n;
+            }
+        }
+        free(out);
+    }
+
+    flock(fd, LOCK_UN);
+    close(fd);
+    free(data);
+    free(encoded);
+}
+
+static int new_session_cb(SSL *ssl, SSL_SESSION *session) {
+    const char *key = SSL_get_ex_data(ssl, key_index);
+    if (!key || !SSL_SESSION_is_resumable(session)) return 0;
+
+    if (!SSL_get_ex_data(ssl, saved_index)) {
+        pthread_mutex_lock(&file_lock);
+        if (session_file) {
+            save_session_file(session_file, key, session);
+            SSL_set_ex_data(ssl, saved_index, (void *)1);
+        }
+        pthread_mutex_unlock(&file_lock);
+    }
+
+    store_session(key, session);
+    return 1;
+}
+
+SSL_CTX* http_tls_context(void) {
+    pthread_once(&init_once, openssl_init);
+
+    pthread_mutex_lock(&ctx_lock);
+    if (!shared_ctx) {
+        shared_ctx = SSL_CTX_new(TLS_client_method());
+        if (!shared_ctx) {
+            fprintf(stderr, "Unable to create SSL context\n");
+            ERR_print_errors_fp(stderr);
+        } else {
+            SSL_CTX_set_session_cache_mode(shared_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+            SSL_CTX_sess_set_new_cb(shared_ctx, new_session_cb);
+#ifdef SSL_OP_ENABLE_KTLS
+            SSL_CTX_set_options(shared_ctx, SSL_OP_ENABLE_KTLS);
+#endif
+        }
+    }
+    SSL_CTX *ctx = shared_ctx;
+    pthread_mutex_unlock(&ctx_lock);
+
+    return ctx;
+}
+
+SSL* http_tls_new(int sockfd, const char *host, int port) {
+    SSL_CTX *ctx = http_tls_context();
+    if (!ctx) return NULL;
+
+    SSL *ssl = SSL_new(ctx);
+    if (!ssl) {
+        ERR_print_errors_fp(stderr);
+        return NULL;
+    }
+
+    char key[SESSION_KEY_SIZE];
+    snprintf(key, sizeof(key), "%s:%d", host, port);
+    char *owned_key = strdup(key);
+    if (!owned_key || !SSL_set_ex_data(ssl, key_index, owned_key)) {
+        free(owned_key);
+        SSL_free(ssl);
+        return NULL;
+    }
+
+    SSL_SESSION *session = lookup_session(key);
+    if (session) {
+        SSL_set_session(ssl, session);
+        SSL_SESSION_free(session);
+    }
+
+    SSL_set_fd(ssl, sockfd);
+    return ssl;
+}
+
+void http_tls_handshake_done(SSL *ssl) {
+    pthread_mutex_lock(&cache_lock);
+    if (SSL_session_reused(ssl)) {
+        session_hits++;
+    } else {
+        session_misses++;
+    }
+    pthread_mutex_unlock(&cache_lock);
+}
+
+SSL* http_tls_connect(int sockfd, const char *host, int port) {
+    SSL *ssl = http_tls_new(sockfd, host, port);
+    if (!ssl) return NULL;
+
+    if (SSL_connect(ssl) <= 0) {
+        fprintf(stderr, "SSL connection failed\n");
+        ERR_print_errors_fp(stderr);
+        SSL_free(ssl);
+        return NULL;
+    }
+
+    http_tls_handshake_done(ssl);
+    return ssl;
+}
+
+int http_tls_ktls(SSL *ssl) {
+    int directions = 0;
+#ifndef OPENSSL_NO_KTLS
+    if (BIO_get_ktls_send(SSL_get_wbio(ssl))) directions |= HTTP_KTLS_SEND;
+    if (BIO_get_ktls_recv(SSL_get_rbio(ssl))) directions |= HTTP_KTLS_RECV;
+#else
+    (void)ssl;
+#endif
+    return directions;
+}
+
+int http_tls_session_cache_file(const char *path) {
+    char *copy = NULL;
+    if (path) {
+        copy = strdup(path);
+        if (!copy) return -1;
+        make_parent_dirs(copy);
+    }
+
+    pthread_mutex_lock(&file_lock);
+    free(session_file);
+    session_file = copy;
+    pthread_mutex_unlock(&file_lock);
+
+    if (copy) {
+        pthread_once(&init_once, openssl_init);
+        load_session_file(copy);
+    }
+    return 0;
+}
+
+void http_tls_session_stats(HttpTlsSessionStats *stats) {
+    if (!stats) return;
+    pthread_mutex_lock(&cache_lock);
+    stats->hits = session_hits;
+    stats->misses = session_misses;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+void http_tls_cleanup(void) {
+    pthread_mutex_lock(&ctx_lock);
+    SSL_CTX_free(shared_ctx);
+    shared_ctx = NULL;
+    pthread_mutex_unlock(&ctx_lock);
+
+    pthread_mutex_lock(&file_lock);
+    free(session_file);
+    session_file = NULL;
+    pthread_mutex_unlock(&file_lock);
+
+    pthread_mutex_lock(&cache_lock);
+    for (size_t i = 0; i < SESSION_CACHE_SIZE; i++) {
+        SSL_SESSION_free(session_cache[i].session);
+        session_cache[i].session = NULL;
+    }
+    pthread_mutex_unlock(&cache_lock);
+}
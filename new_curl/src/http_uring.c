@@ -0,0 +1,419 @@
+/**
+ * @file http_uring.c
+ * @brief Implementation of the io_uring socket transport in C.
+ *
+ * This file contains the implementation of the io_uring transport used by
+ * the http requests functions. It talks to the kernel directly through the
+ * io_uring_setup/io_uring_enter/io_uring_register system calls.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * Every thread lazily creates its own ring, so no locking is needed. Two
+ * buffers are registered with the ring once: outgoing bytes are staged in
+ * the first and sent with IORING_OP_WRITE_FIXED, incoming bytes land in the
+ * second through IORING_OP_READ_FIXED. Registered buffers spare the kernel
+ * from pinning user pages on every operation.
+ *
+ * The multi interface batches instead: the sends and receives of all its
+ * ready connections go into the ring at once with IORING_OP_SEND and
+ * IORING_OP_RECV on the transfers' own buffers, and one io_uring_enter()
+ * runs them all.
+ *
+ * If the kernel lacks io_uring or one of the opcodes (checked with
+ * IORING_REGISTER_PROBE), http_uring_available() reports it and the caller
+ * stays on the classic socket calls.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_uring.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#define RING_ENTRIES 64
+#define SEND_BUFFER_INDEX 0
+#define RECV_BUFFER_INDEX 1
+#define URING_BUFFER_SIZE 16384
+
+typedef struct {
+    int state;                      // 0 not set up yet, 1 ready, -1 unavailable
+    int fd;
+    unsigned entries;               // Submission queue entries
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    char *buffers;                  // Registered region: send buffer, then receive buffer
+} Ring;
+
+static __thread Ring ring;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+
+static void ring_teardown(Ring *r) {
+    if (r->sqes) munmap(r->sqes, r->sqes_size);
+    if (r->cq_ring && r->cq_ring != r->sq_ring) munmap(r->cq_ring, r->cq_ring_size);
+    if (r->sq_ring) munmap(r->sq_ring, r->sq_ring_size);
+    if (r->fd >= 0) close(r->fd);
+    free(r->buffers);
+    memset(r, 0, sizeof(Ring));
+}
+
+/* Thread exit destructor: releases the exiting thread's ring */
+static void ring_destroy(void *ptr) {
+    ring_teardown(ptr);
+}
+
+static void ring_key_create(void) {
+    pthread_key_create(&ring_key, ring_destroy);
+}
+
+/* Checks that the kernel implements every opcode the transport submits */
+static int ring_probe(int fd) {
+    static const int needed[] = { IORING_OP_CONNECT, IORING_OP_WRITE_FIXED, IORING_OP_READ_FIXED,
+                                  IORING_OP_SEND, IORING_OP_RECV };
+    size_t size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = calloc(1, size);
+    if (!probe) return -1;
+
+    int ok = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+    for (size_t i = 0; ok && i < sizeof(needed) / sizeof(needed[0]); i++) {
+        ok = needed[i] <= probe->last_op && (probe->ops[needed[i]].flags & IO_URING_OP_SUPPORTED);
+    }
+    free(probe);
+    return ok ? 0 : -1;
+}
+
+static int ring_setup(Ring *r) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    r->fd = (int)syscall(__NR_io_uring_setup, RING_ENTRIES, &params);
+    if (r->fd < 0) return -1;
+    if (ring_probe(r->fd) < 0) return -1;
+    r->entries = params.sq_entries;
+
+    r->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    r->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (r->cq_ring_size > r->sq_ring_size) r->sq_ring_size = r->cq_ring_size;
+        r->cq_ring_size = r->sq_ring_size;
+    }
+
+    r->sq_ring = mmap(NULL, r->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      r->fd, IORING_OFF_SQ_RING);
+    if (r->sq_ring == MAP_FAILED) {
+        r->sq_ring = NULL;
+        return -1;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        r->cq_ring = r->sq_ring;
+    } else {
+        r->cq_ring = mmap(NULL, r->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          r->fd, IORING_OFF_CQ_RING);
+        if (r->cq_ring == MAP_FAILED) {
+            r->cq_ring = NULL;
+            return -1;
+        }
+    }
+    r->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   r->fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED) {
+        r->sqes = NULL;
+        return -1;
+    }
+
+    char *sq = r->sq_ring;
+    char *cq = r->cq_ring;
+    r->sq_head = (unsigned *)(sq + params.sq_off.head);
+    r->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    r->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    r->sq_array = (unsigned *)(sq + params.sq_off.array);
+    r->cq_head = (unsigned *)(cq + params.cq_off.head);
+    r->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    r->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    r->buffers = aligned_alloc(4096, 2 * URING_BUFFER_SIZE);
+    if (!r->buffers) return -1;
+    struct iovec iov[2] = {
+        { .iov_base = r->buffers, .iov_len = URING_BUFFER_SIZE },
+        { .iov_base = r->buffers + URING_BUFFER_SIZE, .iov_len = URING_BUFFER_SIZE }
+    };
+    if (syscall(__NR_io_uring_register, r->fd, IORING_REGISTER_BUFFERS, iov, 2) < 0) return -1;
+
+    return 0;
+}
+
+/* Returns the calling thread's ring, or NULL if io_uring is unusable */
+static Ring* get_ring(void) {
+    if (ring.state == 0) {
+        if (ring_setup(&ring) == 0) {
+            ring.state = 1;
+            pthread_once(&ring_key_once, ring_key_create);
+            pthread_setspecific(ring_key, &ring);
+        } else {
+            ring_teardown(&ring);
+            ring.state = -1;
+        }
+    }
+    return ring.state == 1 ? &ring : NULL;
+}
+
+/* Queues an operation; linked operations only run if the previous one succeeded in full */
+static struct io_uring_sqe* queue_sqe(Ring *r, unsigned char opcode, int fd, unsigned long long user_data, int link) {
+    unsigned tail = *r->sq_tail;
+    unsigned index = tail & *r->sq_mask;
+    struct io_uring_sqe *sqe = &r->sqes[index];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->user_data = user_data;
+    if (link) sqe->flags = IOSQE_IO_LINK;
+
+    r->sq_array[index] = index;
+    __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+/* Submits the queued operations, waits for all of them and stores their results by user_data */
+static int submit_and_wait(Ring *r, unsigned count, int *results) {
+    unsigned submitted = 0;
+    unsigned completed = 0;
+
+    while (completed < count) {
+        unsigned to_submit = count - submitted;
+        int ret = (int)syscall(__NR_io_uring_enter, r->fd, to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        submitted += (unsigned)ret;
+
+        unsigned head = *r->cq_head;
+        while (head != __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+            if (cqe->user_data < count) results[cqe->user_data] = cqe->res;
+            completed++;
+            head++;
+        }
+        __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+int http_uring_available(void) {
+    return get_ring() != NULL;
+}
+
+int http_uring_connect(int sockfd, const struct sockaddr *addr, socklen_t addrlen) {
+    Ring *r = get_ring();
+    if (!r) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    struct io_uring_sqe *sqe = queue_sqe(r, IORING_OP_CONNECT, sockfd, 0, 0);
+    sqe->addr = (unsigned long long)(uintptr_t)addr;
+    sqe->off = addrlen;
+
+    int result = -ECANCELED;
+    if (submit_and_wait(r, 1, &result) < 0) return -1;
+    if (result < 0) {
+        errno = -result;
+        return -1;
+    }
+    return 0;
+}
+
+ssize_t http_uring_exchange(int sockfd, const struct sockaddr *addr, socklen_t addrlen,
+                            const struct iovec *request, int request_count,
+                            void *response, size_t response_cap, int *connect_failed) {
+    if (connect_failed) *connect_failed = 0;
+    Ring *r = get_ring();
+    if (!r) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    /* The first write carries as much of the request as the registered buffer holds */
+    char *send_buffer = r->buffers;
+    char *recv_buffer = r->buffers + URING_BUFFER_SIZE;
+    size_t request_len = 0;
+    size_t first_len = 0;
+    for (int i = 0; i < request_count; i++) {
+        size_t take = request[i].iov_len < URING_BUFFER_SIZE - first_len ? request[i].iov_len : URING_BUFFER_SIZE - first_len;
+        memcpy(send_buffer + first_len, request[i].iov_base, take);
+        first_len += take;
+        request_len += request[i].iov_len;
+    }
+    size_t recv_len = response_cap < URING_BUFFER_SIZE ? response_cap : URING_BUFFER_SIZE;
+
+    /* connect -> write -> read, each one only started once the previous one fully succeeded */
+    int results[3] = { 0, -ECANCELED, -ECANCELED };
+    unsigned count = 0;
+    if (addr) {
+        struct io_uring_sqe *sqe = queue_sqe(r, IORING_OP_CONNECT, sockfd, count++, 1);
+        sqe->addr = (unsigned long long)(uintptr_t)addr;
+        sqe->off = addrlen;
+    }
+    unsigned write_slot = count;
+    struct io_uring_sqe *sqe = queue_sqe(r, IORING_OP_WRITE_FIXED, sockfd, count++, first_len == request_len);
+    sqe->addr = (unsigned long long)(uintptr_t)send_buffer;
+    sqe->len = (unsigned)first_len;
+    sqe->buf_index = SEND_BUFFER_INDEX;
+    unsigned read_slot = count;
+    if (first_len == request_len) {
+        sqe = queue_sqe(r, IORING_OP_READ_FIXED, sockfd, count++, 0);
+        sqe->addr = (unsigned long long)(uintptr_t)recv_buffer;
+        sqe->len = (unsigned)recv_len;
+        sqe->buf_index = RECV_BUFFER_INDEX;
+    }
+
+    if (submit_and_wait(r, count, results) < 0) return -1;
+    if (addr && results[0] < 0) {
+        if (connect_failed) *connect_failed = 1;
+        errno = -results[0];
+        return -1;
+    }
+    if (results[write_slot] < 0) {
+        errno = -results[write_slot];
+        return -1;
+    }
+
+    /* A short write breaks the link and cancels the read; finish the request, then read */
+    size_t sent = (size_t)results[write_slot];
+    if (count == read_slot || results[read_slot] == -ECANCELED) {
+        for (int i = 0; i < request_count; i++) {
+            if (sent >= request[i].iov_len) {
+                sent -= request[i].iov_len;
+                continue;
+            }
+            while (sent < request[i].iov_len) {
+                ssize_t n = http_uring_send(sockfd, (const char *)request[i].iov_base + sent, request[i].iov_len - sent);
+                if (n <= 0) return -1;
+                sent += (size_t)n;
+            }
+            sent = 0;
+        }
+        return http_uring_recv(sockfd, response, response_cap);
+    }
+
+    if (results[read_slot] < 0) {
+        errno = -results[read_slot];
+        return -1;
+    }
+    memcpy(response, recv_buffer, (size_t)results[read_slot]);
+    return results[read_slot];
+}
+
+int http_uring_batch(HttpUringOp *ops, size_t count) {
+    Ring *r = get_ring();
+    if (!r) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    /* As many operations as the ring holds go in each io_uring_enter(); they are not linked,
+       and MSG_DONTWAIT has a socket that is not ready fail with EAGAIN rather than wait */
+    int results[RING_ENTRIES];
+    for (size_t first = 0; first < count; ) {
+        unsigned batch = count - first < r->entries ? (unsigned)(count - first) : r->entries;
+        if (batch > RING_ENTRIES) batch = RING_ENTRIES;
+        for (unsigned i = 0; i < batch; i++) {
+            HttpUringOp *op = &ops[first + i];
+            struct io_uring_sqe *sqe = queue_sqe(r, op->send ? IORING_OP_SEND : IORING_OP_RECV, op->sockfd, i, 0);
+            sqe->addr = (unsigned long long)(uintptr_t)op->buf;
+            sqe->len = op->len > INT32_MAX ? INT32_MAX : (unsigned)op->len;
+            sqe->msg_flags = MSG_DONTWAIT | (op->send ? MSG_NOSIGNAL : 0);
+            results[i] = -ECANCELED;
+        }
+        if (submit_and_wait(r, batch, results) < 0) return -1;
+        for (unsigned i = 0; i < batch; i++) ops[first + i].result = results[i];
+        first += batch;
+    }
+    return 0;
+}
+
+ssize_t http_uring_send(int sockfd, const void *buf, size_t len) {
+    Ring *r = get_ring();
+    if (!r) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    size_t chunk = len < URING_BUFFER_SIZE ? len : URING_BUFFER_SIZE;
+    memcpy(r->buffers, buf, chunk);
+
+    struct io_uring_sqe *sqe = queue_sqe(r, IORING_OP_WRITE_FIXED, sockfd, 0, 0);
+    sqe->addr = (unsigned long long)(uintptr_t)r->buffers;
+    sqe->len = (unsigned)chunk;
+    sqe->buf_index = SEND_BUFFER_INDEX;
+
+    int result = -ECANCELED;
+    if (submit_and_wait(r, 1, &result) < 0) return -1;
+    if (result < 0) {
+        errno = -result;
+        return -1;
+    }
+    return result;
+}
+
+ssize_t http_uring_recv(int sockfd, void *buf, size_t len) {
+    Ring *r = get_ring();
+    if (!r) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    char *recv_buffer = r->buffers + URING_BUFFER_SIZE;
+    size_t chunk = len < URING_BUFFER_SIZE ? len : URING_BUFFER_SIZE;
+
+    struct io_uring_sqe *sqe = queue_sqe(r, IORING_OP_READ_FIXED, sockfd, 0, 0);
+    sqe->addr = (unsigned long long)(uintptr_t)recv_buffer;
+    sqe->len = (unsigned)chunk;
+    sqe->buf_index = RECV_BUFFER_INDEX;
+
+    int result = -ECANCELED;
+    if (submit_and_wait(r, 1, &result) < 0) return -1;
+    if (result < 0) {
+        errno = -result;
+        return -1;
+    }
+    memcpy(buf, recv_buffer, (size_t)result);
+    return result;
+}
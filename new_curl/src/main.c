@@ -1,14 +1,269 @@
 #include "http.h"
+#include "http_dns.h"
+#include "http_download.h"
+#include "http_output.h"
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+/* Streams the body of a GET to stdout as it arrives, spliced when plaintext; the status goes to stderr on failure */
+static int stream_to_stdout(const char *url) {
+    HttpRequestOptions options = {0};
+    options.sink = HTTP_SINK_FD;
+    options.fd = STDOUT_FILENO;
+    options.zero_copy = 1;
+
+    HttpResponse *response = http_request_ex("GET", url, NULL, &options);
+    if (!response) {
+        fprintf(stderr, "Request failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int status = response->status_code;
+    http_response_free(response);
+    if (status < 200 || status >= 300) {
+        fprintf(stderr, "Status: %d\n", status);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Downloads an object into a file in up to streams parallel ranges */
+static int download_segmented(const char *url, const char *path, int use_mmap, size_t streams) {
+    HttpOutput *output = http_output_open(path, use_mmap ? HTTP_OUTPUT_MMAP : 0);
+    if (!output) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+
+    HttpDownloadOptions options = {0};
+    options.max_streams = streams;
+    int status = http_download(url, output, &options, NULL);
+    if (http_output_close(output) < 0) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    if (status < 0) {
+        fprintf(stderr, "Download failed\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Produces a request body from stdin */
+static long read_stdin(char *buffer, size_t size, void *userdata) {
+    (void)userdata;
+    for (;;) {
+        ssize_t n = read(STDIN_FILENO, buffer, size);
+        if (n < 0 && errno == EINTR) continue;
+        return (long)n;
+    }
+}
+
+/* Writes the default TLS session file path, under $XDG_CACHE_HOME or ~/.cache, into path */
+static int default_session_file(char *path, size_t size) {
+    const char *cache = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    int len;
+    if (cache && cache[0] == '/') len = snprintf(path, size, "%s/new_curl/tls_sessions", cache);
+    else if (home && *home) len = snprintf(path, size, "%s/.cache/new_curl/tls_sessions", home);
+    else return -1;
+    return len > 0 && (size_t)len < size ? 0 : -1;
+}
+
+/* Reads "coding[:level]" (e.g., "gzip:9") into the body compression options */
+static int parse_body_coding(const char *arg, HttpRequestOptions *options) {
+    size_t len = strcspn(arg, ":");
+    if (len == 4 && strncmp(arg, "gzip", len) == 0) options->body_coding = HTTP_CODING_GZIP;
+    else if (len == 7 && strncmp(arg, "deflate", len) == 0) options->body_coding = HTTP_CODING_DEFLATE;
+    else if (len == 4 && strncmp(arg, "zstd", len) == 0) options->body_coding = HTTP_CODING_ZSTD;
+    else return -1;
+
+    options->body_level = 0;
+    if (arg[len] == ':') {
+        char *end;
+        errno = 0;
+        long level = strtol(arg + len + 1, &end, 10);
+        if (end == arg + len + 1 || *end != '\0' || errno != 0 || level < INT_MIN || level > INT_MAX) return -1;
+        options->body_level = (int)level;
+    }
+    return 0;
+}
+
+/* PUTs a file, sent by the kernel with sendfile(), or stdin ("-") in chunks as it is read, compressed
+   on the way if asked to; the status goes to stderr on failure */
+static int upload_file(const char *url, const char *path, const HttpRequestOptions *coding) {
+    HttpRequestOptions options = *coding;
+    int fd = -1;
+    if (strcmp(path, "-") == 0) {
+        options.body_source = HTTP_BODY_PRODUCER;
+        options.producer = read_stdin;
+    } else {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            perror(path);
+            return EXIT_FAILURE;
+        }
+        options.body_source = HTTP_BODY_FD;
+        options.body_fd = fd;
+    }
+    HttpResponse *response = http_request_ex("PUT", url, NULL, &options);
+    if (fd >= 0) close(fd);
+    if (!response) {
+        fprintf(stderr, "Request failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int status = response->status_code;
+    http_response_free(response);
+    if (status < 200 || status >= 300) {
+        fprintf(stderr, "Status: %d\n", status);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Downloads an object into a file, resuming what an interrupted run left in it */
+static int download_resumable(const char *url, const char *path) {
+    HttpDownloadStats stats;
+    if (http_download_resume(url, path, &stats) < 0) {
+        fprintf(stderr, "Download failed, run again to resume it\n");
+        return EXIT_FAILURE;
+    }
+    if (stats.resumed_from > 0) fprintf(stderr, "Resumed from byte %llu\n", stats.resumed_from);
+    return EXIT_SUCCESS;
+}
+
+/* Downloads the body of a GET into a file preallocated from Content-Length, through mmap() if asked to */
+static int download_to_file(const char *url, const char *path, int use_mmap) {
+    HttpOutput *output = http_output_open(path, use_mmap ? HTTP_OUTPUT_MMAP : 0);
+    if (!output) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+
+    HttpRequestOptions options = {0};
+    options.sink = HTTP_SINK_OUTPUT;
+    options.output = output;
+
+    HttpResponse *response = http_request_ex("GET", url, NULL, &options);
+    int status = response ? response->status_code : 0;
+    http_response_free(response);
+    if (http_output_close(output) < 0) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    if (!response) {
+        fprintf(stderr, "Request failed\n");
+        return EXIT_FAILURE;
+    }
+    if (status < 200 || status >= 300) {
+        fprintf(stderr, "Status: %d\n", status);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <URL>\n", argv[0]);
+    int stream = 0;
+    const char *output_path = NULL;
+    int use_mmap = 0;
+    long streams = 0;
+    int resume = 0;
+    const char *upload_path = NULL;
+    HttpRequestOptions upload_coding = {0};
+    int opt;
+    while ((opt = getopt(argc, argv, "so:mp:cT:z:")) != -1) {
+        switch (opt) {
+        case 's':
+            stream = 1;
+            break;
+        case 'o':
+            output_path = optarg;
+            break;
+        case 'm':
+            use_mmap = 1;
+            break;
+        case 'p':
+            streams = strtol(optarg, NULL, 10);
+            if (streams < 1) streams = -1;
+            break;
+        case 'c':
+            resume = 1;
+            break;
+        case 'T':
+            upload_path = optarg;
+            break;
+        case 'z':
+            if (parse_body_coding(optarg, &upload_coding) < 0) upload_coding.body_coding = HTTP_CODING_UNSUPPORTED;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-s] [-o file [-m] [-p streams] [-c]] [-T file [-z coding[:level]]] <URL>\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 1 || ((use_mmap || streams || resume) && !output_path) || streams < 0 ||
+        (resume && (use_mmap || streams)) || (upload_path && (stream || output_path)) ||
+        (upload_coding.body_coding != HTTP_CODING_IDENTITY && !upload_path) ||
+        upload_coding.body_coding == HTTP_CODING_UNSUPPORTED) {
+        fprintf(stderr, "Usage: %s [-s] [-o file [-m] [-p streams] [-c]] [-T file [-z coding[:level]]] <URL>\n", argv[0]);
         return EXIT_FAILURE;
     }
 
-    const char *url = argv[1];
+    const char *url = argv[optind];
+
+    /* A keep-alive connection closed by the server must not kill us on write */
+    signal(SIGPIPE, SIG_IGN);
+
+    /* NEW_CURL_TRANSPORT=io_uring batches socket calls; unsupported kernels keep the classic path */
+    const char *transport = getenv("NEW_CURL_TRANSPORT");
+    if (transport && strcmp(transport, "io_uring") == 0 && http_set_transport(HTTP_TRANSPORT_IO_URING) < 0) {
+        fprintf(stderr, "io_uring is not available, using the classic transport\n");
+    }
+
+    /* NEW_CURL_DNS_SERVERS=<address[:port],...> asks these DNS servers instead of those of resolv.conf */
+    const char *dns_servers = getenv("NEW_CURL_DNS_SERVERS");
+    if (dns_servers && *dns_servers && http_dns_set_servers(dns_servers) < 0) {
+        fprintf(stderr, "Invalid NEW_CURL_DNS_SERVERS, using the servers of resolv.conf\n");
+    }
+
+    /* TLS sessions negotiated by earlier invocations are resumed from ~/.cache/new_curl/tls_sessions,
+       or from NEW_CURL_TLS_SESSIONS=<file>; an empty NEW_CURL_TLS_SESSIONS keeps them in memory only */
+    char default_sessions[PATH_MAX];
+    const char *session_file = getenv("NEW_CURL_TLS_SESSIONS");
+    if (!session_file && default_session_file(default_sessions, sizeof(default_sessions)) == 0) {
+        session_file = default_sessions;
+    }
+    if (session_file && *session_file) http_tls_session_cache_file(session_file);
+
+    /* -s: only fetch the body, straight to stdout, without holding it in memory */
+    if (stream) {
+        int status = stream_to_stdout(url);
+        http_cleanup();
+        return status;
+    }
+
+    /* -T: only PUT the file (-z: compressed with gzip, deflate or zstd) */
+    if (upload_path) {
+        int status = upload_file(url, upload_path, &upload_coding);
+        http_cleanup();
+        return status;
+    }
+
+    /* -o: only fetch the body, into a file reserved up front (-m: written through a mapping,
+       -p: in up to that many parallel ranges, -c: resuming a partial file) */
+    if (output_path) {
+        int status = resume ? download_resumable(url, output_path)
+                   : streams > 0 ? download_segmented(url, output_path, use_mmap, (size_t)streams)
+                   : download_to_file(url, output_path, use_mmap);
+        http_cleanup();
+        return status;
+    }
 
     HttpResponse *response = http_get(url);
     if (response) {
@@ -83,5 +338,6 @@ int main(int argc, char *argv[]) {
         http_response_free(response);
     }
 
+    http_cleanup();
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""
+@file dns_server.py
+@brief Stand-in DNS server for the resolver test.
+
+This file contains a small authoritative server for the "test" zone,
+answering A queries over UDP and TCP on the loopback interface.
+
+@author Junior ADI
+@date October 16th, 2026
+@location Yamoussoukro, Côte d'Ivoire, West Africa
+
+@details
+It listens on 127.0.0.1 at the given port, and answers SERVFAIL to every
+query on the next port, to stand for a broken server. Unprivileged ports
+work, so it needs no root. The names it knows:
+- svc.test: 127.0.0.1.
+- big.test: 40 addresses, which do not fit in 512 bytes: over UDP the
+  answer comes back empty and truncated, over TCP whole.
+- failover.test, failover<anything>.test: 127.0.0.1.
+- flip.test, flipshort.test: NXDOMAIN the first time they are asked, with
+  an SOA minimum of 3600 and 2 seconds; 127.0.0.1 afterwards.
+- any other name: NXDOMAIN, with an SOA minimum of 5 seconds.
+Given a command after the port, it runs it once both ports are bound and
+exits with its status; `make test` runs the resolver test that way.
+
+@license
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+"""
+import collections
+import socket
+import struct
+import subprocess
+import sys
+import threading
+
+TYPE_A, TYPE_SOA = 1, 6
+RCODE_SERVFAIL, RCODE_NXDOMAIN = 2, 3
+
+asked = collections.Counter()   # Queries per name
+asked_lock = threading.Lock()
+
+
+def encode_name(name):
+    return b''.join(bytes([len(label)]) + label.encode() for label in name.split('.')) + b'\0'
+
+
+def record(name, rtype, ttl, rdata):
+    return encode_name(name) + struct.pack('!HHIH', rtype, 1, ttl, len(rdata)) + rdata
+
+
+def address(name, ip, ttl=300):
+    return record(name, TYPE_A, ttl, socket.inet_aton(ip))
+
+
+def soa(minimum):
+    rdata = encode_name('ns.test') + encode_name('admin.test') + struct.pack('!IIIII', 1, 60, 60, 60, minimum)
+    return record('test', TYPE_SOA, 3600, rdata)
+
+
+def parse_question(query):
+    """Returns the lower-case name, type and raw question of a query"""
+    pos, labels = 12, []
+    while query[pos]:
+        length = query[pos]
+        labels.append(query[pos + 1:pos + 1 + length].decode())
+        pos += 1 + length
+    qtype = struct.unpack('!H', query[pos + 1:pos + 3])[0]
+    return '.'.join(labels).lower(), qtype, query[12:pos + 5]
+
+
+def lookup(name, times):
+    """Returns the rcode, answer and authority records for a name asked for the times-th time"""
+    if name == 'svc.test' or (name.startswith('failover') and name.endswith('.test')):
+        return 0, [address(name, '127.0.0.1')], []
+    if name == 'big.test':
+        return 0, [address(name, '127.0.0.%d' % (i + 1)) for i in range(40)], []
+    if name in ('flip.test', 'flipshort.test'):
+        if times > 1:
+            return 0, [address(name, '127.0.0.1')], []
+        return RCODE_NXDOMAIN, [], [soa(3600 if name == 'flip.test' else 2)]
+    return RCODE_NXDOMAIN, [], [soa(5)]
+
+
+def respond(query, tcp, broken):
+    qid, flags = struct.unpack('!HH', query[:4])
+    name, qtype, question = parse_question(query)
+    with asked_lock:
+        asked[name] += 1
+        times = asked[name]
+
+    rcode, answers, authority = (RCODE_SERVFAIL, [], []) if broken else lookup(name, times)
+    if qtype != TYPE_A and rcode == 0:
+        answers = []
+    truncated = 0
+    body = b''.join(answers) + b''.join(authority)
+    if not tcp and 12 + len(question) + len(body) > 512:
+        truncated, answers, authority, body = 0x200, [], [], b''
+    # Response, authoritative, recursion available, the recursion desired bit copied
+    header = struct.pack('!HHHHHH', qid, 0x8480 | truncated | rcode | (flags & 0x100), 1,
+                         len(answers), len(authority), 0)
+    return header + question + body
+
+
+def serve_udp(sock, broken):
+    while True:
+        query, peer = sock.recvfrom(4096)
+        sock.sendto(respond(query, False, broken), peer)
+
+
+def serve_tcp_client(conn, broken):
+    with conn:
+        while True:
+            prefix = conn.recv(2)
+            if len(prefix) < 2:
+                return
+            length = struct.unpack('!H', prefix)[0]
+            query = b''
+            while len(query) < length:
+                data = conn.recv(length - len(query))
+                if not data:
+                    return
+                query += data
+            reply = respond(query, True, broken)
+            conn.sendall(struct.pack('!H', len(reply)) + reply)
+
+
+def serve_tcp(sock, broken):
+    while True:
+        conn, _ = sock.accept()
+        threading.Thread(target=serve_tcp_client, args=(conn, broken), daemon=True).start()
+
+
+def listen(port, broken):
+    udp = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    udp.bind(('127.0.0.1', port))
+    tcp = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    tcp.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    tcp.bind(('127.0.0.1', port))
+    tcp.listen(16)
+    threading.Thread(target=serve_udp, args=(udp, broken), daemon=True).start()
+    threading.Thread(target=serve_tcp, args=(tcp, broken), daemon=True).start()
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit('Usage: %s <port> [command...]' % sys.argv[0])
+    port = int(sys.argv[1])
+    listen(port, False)
+    listen(port + 1, True)
+    if len(sys.argv) > 2:
+        sys.exit(subprocess.call(sys.argv[2:]))
+    threading.Event().wait()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+@file http_server.py
+@brief Stand-in HTTP server for the download test.
+
+This file contains a small HTTP/1.1 server serving one test object, with
+byte ranges and gzip, on the loopback interface.
+
+@author Junior ADI
+@date October 16th, 2026
+@location Yamoussoukro, Côte d'Ivoire, West Africa
+
+@details
+It listens on 127.0.0.1 at the given port. The test object is OBJECT_SIZE
+bytes of numbered lines, "%08d\\n", with a strong ETag. The paths it knows:
+- /text: the object, gzip-compressed whenever the request accepts gzip and
+  asks for no range, as web servers do with text; HEAD answers the same
+  headers as GET would, so a HEAD accepting gzip gets the compressed
+  Content-Length. A Range is answered with a 206 of identity bytes.
+- /shifted: the object, but a Range is answered with a 206 starting
+  SHIFT bytes before the first byte asked for, as a broken cache would.
+- /chunked, /close: the object in a 200 without Content-Length, chunked
+  or up to the close of the connection, whatever range is asked for.
+- /empty: an empty 200, whatever range is asked for, as for an object
+  emptied since a download of it started.
+Given a command after the port, it runs it once the port is bound and
+exits with its status; `make test` runs the download test that way.
+
+@license
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+"""
+import gzip
+import http.server
+import re
+import subprocess
+import sys
+import threading
+
+OBJECT_SIZE = 3 * 1024 * 1024
+OBJECT = b''.join(b'%08d\n' % i for i in range(OBJECT_SIZE // 9 + 1))[:OBJECT_SIZE]
+OBJECT_GZIP = gzip.compress(OBJECT, 6)
+ETAG = '"test-object-1"'
+SHIFT = 100
+
+
+def parse_range(value):
+    """Returns the first and last byte of a "bytes=first-[last]" range, or None"""
+    match = re.fullmatch(r'bytes=(\d+)-(\d*)', value or '')
+    if not match:
+        return None
+    first = int(match.group(1))
+    last = int(match.group(2)) if match.group(2) else OBJECT_SIZE - 1
+    return first, min(last, OBJECT_SIZE - 1)
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+
+    def log_message(self, *args):
+        pass
+
+    def reply(self, status, body, headers):
+        self.send_response(status)
+        for name, value in headers:
+            self.send_header(name, value)
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        if self.command != 'HEAD':
+            self.wfile.write(body)
+
+    def serve_unsized(self, chunked):
+        """Sends the object without a length, in 64 KB chunks or up to the close"""
+        self.send_response(200)
+        self.send_header('ETag', ETAG)
+        if chunked:
+            self.send_header('Transfer-Encoding', 'chunked')
+        else:
+            self.send_header('Connection', 'close')
+            self.close_connection = True
+        self.end_headers()
+        if self.command == 'HEAD':
+            return
+        for start in range(0, OBJECT_SIZE, 65536):
+            piece = OBJECT[start:start + 65536]
+            self.wfile.write(b'%x\r\n%s\r\n' % (len(piece), piece) if chunked else piece)
+        if chunked:
+            self.wfile.write(b'0\r\n\r\n')
+
+    def serve_text(self, shift=0):
+        requested = parse_range(self.headers.get('Range'))
+        headers = [('Accept-Ranges', 'bytes'), ('ETag', ETAG)]
+        if requested:
+            first, last = requested
+            first = max(first - shift, 0)
+            if first >= OBJECT_SIZE:
+                self.reply(416, b'', headers + [('Content-Range', 'bytes */%d' % OBJECT_SIZE)])
+                return
+            self.reply(206, OBJECT[first:last + 1],
+                       headers + [('Content-Range', 'bytes %d-%d/%d' % (first, last, OBJECT_SIZE))])
+        elif 'gzip' in self.headers.get('Accept-Encoding', ''):
+            self.reply(200, OBJECT_GZIP, headers + [('Content-Encoding', 'gzip')])
+        else:
+            self.reply(200, OBJECT, headers)
+
+    def do_GET(self):
+        if self.path == '/text':
+            self.serve_text()
+        elif self.path == '/shifted':
+            self.serve_text(SHIFT)
+        elif self.path in ('/chunked', '/close'):
+            self.serve_unsized(self.path == '/chunked')
+        elif self.path == '/empty':
+            self.reply(200, b'', [('ETag', '"empty-1"')])
+        else:
+            self.reply(404, b'', [])
+
+    do_HEAD = do_GET
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit('Usage: %s <port> [command...]' % sys.argv[0])
+    server = http.server.ThreadingHTTPServer(('127.0.0.1', int(sys.argv[1])), Handler)
+    server.daemon_threads = True
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    if len(sys.argv) > 2:
+        sys.exit(subprocess.call(sys.argv[2:]))
+    threading.Event().wait()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,171 @@
+/**
+ * @file test_dns.c
+ * @brief Resolver test against the stand-in DNS server in C.
+ *
+ * This file contains a program driving the resolver of http_dns.c against
+ * tests/dns_server.py, listening on the loopback interface.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * The program takes the port of the stand-in server, the next port being
+ * its broken twin answering SERVFAIL, and checks:
+ * - A plain answer over UDP.
+ * - An answer too large for UDP, asked again over TCP, through the lookups
+ *   that do not block.
+ * - A server answering SERVFAIL, skipped for the next one, and a lookup no
+ *   server answers, which is not cached.
+ * - Names that do not exist, cached for the SOA minimum of their zone, and
+ *   no longer than DNS_NEGATIVE_TTL seconds however large that minimum is.
+ * It prints a line per failed check and exits with a non-zero status if
+ * any failed. Build and run it with `make test`; it takes about a dozen
+ * seconds, waiting for negative answers to go stale.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_dns.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+/* Longest a negative answer is cached, as in http_dns.c */
+#define NEGATIVE_TTL_CAP 10
+
+static int failures = 0;
+
+#define CHECK(condition, what) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "FAILED: %s (%s:%d)\n", what, __FILE__, __LINE__); \
+            failures++; \
+        } \
+    } while (0)
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) < 0 && errno == EINTR) {}
+}
+
+static int is_address(const HttpDnsAddresses *addresses, size_t index, const char *expected) {
+    struct in_addr address;
+    inet_pton(AF_INET, expected, &address);
+    return index < addresses->count && addresses->addresses[index].s_addr == address.s_addr;
+}
+
+/* Resolves a name with the lookups that do not block, driven by poll() as an event loop would */
+static int resolve_async(const char *host, HttpDnsAddresses *result) {
+    HttpDnsLookup *lookup;
+    if (http_dns_lookup_start(host, result, &lookup) < 0) return -1;
+    int status = 1;
+    while (lookup && (status = http_dns_lookup_process(lookup, result)) == 0) {
+        int want_write;
+        struct pollfd pfd = { .fd = http_dns_lookup_fd(lookup, &want_write) };
+        pfd.events = want_write ? POLLOUT : POLLIN;
+        poll(&pfd, 1, http_dns_lookup_timeout(lookup));
+    }
+    http_dns_lookup_free(lookup);
+    return status < 0 ? -1 : 0;
+}
+
+static void test_udp(void) {
+    HttpDnsAddresses addresses;
+    CHECK(http_dns_resolve("svc.test", &addresses) == 0, "svc.test resolves over UDP");
+    CHECK(addresses.count == 1 && is_address(&addresses, 0, "127.0.0.1"), "svc.test is 127.0.0.1");
+}
+
+static void test_tcp_fallback(void) {
+    /* Over UDP the answer comes back empty: only TCP gets the addresses */
+    HttpDnsAddresses addresses;
+    CHECK(resolve_async("big.test", &addresses) == 0, "big.test resolves over TCP");
+    CHECK(addresses.count == HTTP_DNS_MAX_ADDRESSES, "big.test keeps HTTP_DNS_MAX_ADDRESSES addresses");
+    CHECK(is_address(&addresses, 0, "127.0.0.1"), "big.test starts with 127.0.0.1");
+
+    CHECK(http_dns_resolve("big.test", &addresses) == 0 && addresses.count == HTTP_DNS_MAX_ADDRESSES,
+          "big.test is answered from the cache");
+}
+
+static void test_failover(const char *server, const char *broken) {
+    char servers[64];
+    HttpDnsAddresses addresses;
+
+    /* The broken server is asked first, then the working one */
+    snprintf(servers, sizeof(servers), "%s,%s", broken, server);
+    CHECK(http_dns_set_servers(servers) == 0, "two servers are set");
+    CHECK(http_dns_resolve("failover.test", &addresses) == 0, "failover.test resolves past SERVFAIL");
+    CHECK(is_address(&addresses, 0, "127.0.0.1"), "failover.test is 127.0.0.1");
+
+    /* No server answers: the failure is not remembered */
+    CHECK(http_dns_set_servers(broken) == 0, "the broken server is set");
+    CHECK(http_dns_resolve("failover2.test", &addresses) < 0, "a name only SERVFAIL answers does not resolve");
+    CHECK(http_dns_set_servers(server) == 0, "the working server is set back");
+    CHECK(http_dns_resolve("failover2.test", &addresses) == 0, "failover2.test is asked again");
+
+    CHECK(http_dns_set_servers("127.0.0.1:0") < 0, "port 0 is refused");
+    CHECK(http_dns_set_servers("localhost:53") < 0, "host names are refused");
+    CHECK(http_dns_set_servers("127.0.0.1:53x") < 0, "trailing characters are refused");
+}
+
+static void test_negative_ttl(void) {
+    /* Both names exist from their second query on: until then a failure is a cached answer. They
+       end with a dot, so that no search domain, with a negative TTL of its own, is tried */
+    HttpDnsAddresses addresses;
+    CHECK(http_dns_resolve("flip.test.", &addresses) < 0, "flip.test does not exist at first");
+    CHECK(http_dns_resolve("flipshort.test.", &addresses) < 0, "flipshort.test does not exist at first");
+    sleep_ms(500);
+    CHECK(http_dns_resolve("flip.test.", &addresses) < 0, "flip.test is cached as missing");
+    CHECK(http_dns_resolve("flipshort.test.", &addresses) < 0, "flipshort.test is cached as missing");
+
+    /* flipshort.test goes stale after its SOA minimum of 2 seconds */
+    sleep_ms(2700);
+    CHECK(http_dns_resolve("flipshort.test.", &addresses) == 0, "flipshort.test is asked again after its SOA minimum");
+    CHECK(http_dns_resolve("flip.test.", &addresses) < 0, "flip.test is still cached as missing");
+
+    /* flip.test has an SOA minimum of an hour, but is kept no longer than the cap */
+    sleep_ms(NEGATIVE_TTL_CAP * 1000 - 2000);
+    CHECK(http_dns_resolve("flip.test.", &addresses) == 0, "flip.test is asked again after the negative TTL cap");
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <port of tests/dns_server.py>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    int port = atoi(argv[1]);
+    char server[32], broken[32];
+    snprintf(server, sizeof(server), "127.0.0.1:%d", port);
+    snprintf(broken, sizeof(broken), "127.0.0.1:%d", port + 1);
+    if (http_dns_set_servers(server) < 0) {
+        fprintf(stderr, "Invalid port %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    test_udp();
+    test_tcp_fallback();
+    test_failover(server, broken);
+    test_negative_ttl();
+    http_dns_flush();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All resolver checks passed\n");
+    return EXIT_SUCCESS;
+}
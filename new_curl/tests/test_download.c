@@ -0,0 +1,238 @@
+/**
+ * @file test_download.c
+ * @brief Download test against the stand-in HTTP server in C.
+ *
+ * This file contains a program driving the downloads of http_download.c
+ * against tests/http_server.py, listening on the loopback interface.
+ *
+ * @author Junior ADI
+ * @date October 16th, 2026
+ * @location Yamoussoukro, Côte d'Ivoire, West Africa
+ *
+ * @details
+ * The program takes the port of the stand-in server and checks, byte for
+ * byte against the object the server holds:
+ * - A download in parallel ranges from a server that compresses the object
+ *   for requests accepting gzip: the ranges are sized from the identity
+ *   length, not from the compressed one.
+ * - A download in one piece, decoded as it arrives.
+ * - A resumed download from the same server, fetched uncompressed in one
+ *   request, since the offsets it resumes from are identity ones.
+ * - Resumed downloads of a body without a length, chunked or up to the
+ *   close, complete once the body ends.
+ * - A partial file resumed from a server answering another range than the
+ *   one asked for: the file is fetched again rather than corrupted.
+ * - A partial file resumed from an object now empty: the empty 200 that
+ *   answers the range replaces it.
+ * Files go to a directory of their own under /tmp, removed at the end. It
+ * prints a line per failed check and exits with a non-zero status if any
+ * failed. Build and run it with `make test`.
+ *
+ * @license
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "http_download.h"
+#include "http_output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Size of the test object, as in tests/http_server.py */
+#define OBJECT_SIZE (3 * 1024 * 1024)
+
+static int failures = 0;
+static char directory[] = "/tmp/new_curl_test_XXXXXX";
+static char base_url[64];
+
+#define CHECK(condition, what) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "FAILED: %s (%s:%d)\n", what, __FILE__, __LINE__); \
+            failures++; \
+        } \
+    } while (0)
+
+static void path_of(char *path, size_t size, const char *name) {
+    snprintf(path, size, "%s/%s", directory, name);
+}
+
+static void url_of(char *url, size_t size, const char *path) {
+    snprintf(url, size, "%s%s", base_url, path);
+}
+
+/* Tells whether a file holds the test object: numbered lines, "%08d\n" */
+static int holds_object(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+    char *data = malloc(OBJECT_SIZE + 1);
+    size_t len = data ? fread(data, 1, OBJECT_SIZE + 1, fp) : 0;
+    fclose(fp);
+
+    int same = len == OBJECT_SIZE;
+    char line[24];
+    for (size_t offset = 0; same && offset < len; offset += 9) {
+        snprintf(line, sizeof(line), "%08zu\n", offset / 9);
+        size_t n = len - offset < 9 ? len - offset : 9;
+        same = memcmp(data + offset, line, n) == 0;
+    }
+    free(data);
+    return same;
+}
+
+static void test_segmented_compressing_server(void) {
+    char path[128], url[128];
+    path_of(path, sizeof(path), "segmented.bin");
+    url_of(url, sizeof(url), "/text");
+
+    HttpOutput *output = http_output_open(path, 0);
+    CHECK(output != NULL, "the output file opens");
+    if (!output) return;
+    HttpDownloadOptions options = { .max_streams = 4, .min_segment = 64 * 1024 };
+    HttpDownloadStats stats;
+    int status = http_download(url, output, &options, &stats);
+    CHECK(http_output_close(output) == 0 && status == 0, "the download in ranges succeeds");
+    CHECK(stats.segmented && stats.size == OBJECT_SIZE, "the ranges cover the identity length");
+    CHECK(holds_object(path), "the download in ranges holds the whole object");
+    unlink(path);
+}
+
+static void test_whole_compressed(void) {
+    char path[128], url[128];
+    path_of(path, sizeof(path), "whole.bin");
+    url_of(url, sizeof(url), "/text");
+
+    HttpOutput *output = http_output_open(path, 0);
+    CHECK(output != NULL, "the output file opens");
+    if (!output) return;
+    HttpDownloadOptions options = { .max_streams = 1 };
+    int status = http_download(url, output, &options, NULL);
+    CHECK(http_output_close(output) == 0 && status == 0, "the download in one piece succeeds");
+    CHECK(holds_object(path), "the download in one piece holds the decoded object");
+    unlink(path);
+}
+
+static void test_resume_identity(void) {
+    char path[128], resume_file[160], url[128];
+    path_of(path, sizeof(path), "resumed.bin");
+    snprintf(resume_file, sizeof(resume_file), "%s.resume", path);
+    url_of(url, sizeof(url), "/text");
+
+    HttpDownloadStats stats;
+    CHECK(http_download_resume(url, path, &stats) == 0, "the resumed download succeeds");
+    CHECK(stats.size == OBJECT_SIZE && stats.retries == 0, "the resumed download takes one identity request");
+    CHECK(holds_object(path), "the resumed download holds the whole object");
+    CHECK(access(resume_file, F_OK) != 0, "the validator file is removed once complete");
+    unlink(path);
+    unlink(resume_file);
+}
+
+/* Writes a partial file and its validator, as an interrupted download leaves them */
+static int write_partial(const char *path, const char *resume_file, const char *data, const char *validator) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return -1;
+    int status = fputs(data, fp) < 0 ? -1 : 0;
+    if (fclose(fp) != 0) status = -1;
+    fp = fopen(resume_file, "w");
+    if (!fp) return -1;
+    if (fprintf(fp, "%s\n", validator) < 0) status = -1;
+    if (fclose(fp) != 0) status = -1;
+    return status;
+}
+
+static long file_size(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+static void test_resume_unsized(const char *name) {
+    char path[128], resume_file[160], url[128];
+    path_of(path, sizeof(path), "unsized.bin");
+    snprintf(resume_file, sizeof(resume_file), "%s.resume", path);
+    url_of(url, sizeof(url), name);
+
+    HttpDownloadStats stats;
+    CHECK(http_download_resume(url, path, &stats) == 0, "the download of a body without a length succeeds");
+    CHECK(stats.size == OBJECT_SIZE && stats.retries == 0, "the body that ran to its end is the whole object");
+    CHECK(holds_object(path), "the download of a body without a length holds the whole object");
+    CHECK(access(resume_file, F_OK) != 0, "the validator file is removed once complete");
+    unlink(path);
+    unlink(resume_file);
+}
+
+static void test_resume_wrong_range(void) {
+    char path[128], resume_file[160], url[128], partial[1024];
+    path_of(path, sizeof(path), "shifted.bin");
+    snprintf(resume_file, sizeof(resume_file), "%s.resume", path);
+    url_of(url, sizeof(url), "/shifted");
+
+    /* The first lines of the object, as a download cut short leaves them */
+    size_t len = 0;
+    for (size_t line = 0; len + 9 < sizeof(partial); line++) len += (size_t)snprintf(partial + len, 10, "%08zu\n", line);
+    CHECK(write_partial(path, resume_file, partial, "\"test-object-1\"") == 0, "the partial file is written");
+
+    HttpDownloadStats stats;
+    CHECK(http_download_resume(url, path, &stats) == 0, "the download past a wrong range succeeds");
+    CHECK(stats.retries > 0, "the wrong range is refused");
+    CHECK(holds_object(path), "the wrong range is not written into the file");
+    unlink(path);
+    unlink(resume_file);
+}
+
+static void test_resume_empty(void) {
+    char path[128], resume_file[160], url[128];
+    path_of(path, sizeof(path), "emptied.bin");
+    snprintf(resume_file, sizeof(resume_file), "%s.resume", path);
+    url_of(url, sizeof(url), "/empty");
+
+    CHECK(write_partial(path, resume_file, "stale bytes", "\"old-1\"") == 0, "the partial file is written");
+    HttpDownloadStats stats;
+    CHECK(http_download_resume(url, path, &stats) == 0, "the download of an emptied object succeeds");
+    CHECK(file_size(path) == 0, "the empty 200 replaces the partial file");
+    CHECK(access(resume_file, F_OK) != 0, "the old validator is removed");
+    unlink(path);
+    unlink(resume_file);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <port of tests/http_server.py>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    snprintf(base_url, sizeof(base_url), "http://127.0.0.1:%d", atoi(argv[1]));
+    if (!mkdtemp(directory)) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+
+    test_segmented_compressing_server();
+    test_whole_compressed();
+    test_resume_identity();
+    test_resume_unsized("/chunked");
+    test_resume_unsized("/close");
+    test_resume_wrong_range();
+    test_resume_empty();
+    rmdir(directory);
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All download checks passed\n");
+    return EXIT_SUCCESS;
+}